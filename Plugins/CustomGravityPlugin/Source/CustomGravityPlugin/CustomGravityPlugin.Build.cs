@@ -39,7 +39,7 @@ public class CustomGravityPlugin : ModuleRules
 		PrivateDependencyModuleNames.AddRange(
 			new string[]
 			{
-				"Slate", "SlateCore"
+				"Slate", "SlateCore", "PhysX", "APEX"
 				// ... add private dependencies that you statically link with here ...	
 			}
 			);
@@ -21,6 +21,7 @@ ACustomPhysicsActor::ACustomPhysicsActor(const FObjectInitializer& ObjectInitial
 	if (GravityComponent)
 	{
 		GravityComponent->SetUpdatedComponent(MeshComponent);
+		GravityComponent->SetSkipGravityWhileSleeping(true);
 	}
 
 }
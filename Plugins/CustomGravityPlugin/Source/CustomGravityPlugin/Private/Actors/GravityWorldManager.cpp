@@ -0,0 +1,675 @@
+// Copyright 2015 Elhoussine Mehnik (Mhousse1247). All Rights Reserved.
+//******************* http://ue4resources.com/ *********************//
+
+
+#include "CustomGravityPluginPrivatePCH.h"
+#include "Async/ParallelFor.h"
+
+static TAutoConsoleVariable<int32> CVarParallelMovementBatch(
+	TEXT("CustomGravity.ParallelMovementBatch"),
+	1,
+	TEXT("0 : the batched movement pass runs on the game thread only.\n")
+	TEXT("1 : the math of the batched movement pass is spread over the worker threads (default)."),
+	ECVF_Default);
+
+/** Below this number of entries the batched movement pass is not worth dispatching to the worker threads. */
+static const int32 MinParallelMovementBatchSize = 32;
+
+
+int32 FGravityComponentBatch::Add(UCustomGravityComponent* Component, UPrimitiveComponent* UpdatedComponent, float GravityScale)
+{
+	UpdatedComponents.Add(UpdatedComponent);
+	GravityScales.Add(GravityScale);
+	SignificanceTiers.Add(EGravitySignificance::EGS_High);
+	LastGravityForces.Add(FVector::ZeroVector);
+	return Components.Add(Component);
+}
+
+UCustomGravityComponent* FGravityComponentBatch::RemoveAtSwap(int32 Index)
+{
+	Components.RemoveAtSwap(Index, 1, false);
+	UpdatedComponents.RemoveAtSwap(Index, 1, false);
+	GravityScales.RemoveAtSwap(Index, 1, false);
+	SignificanceTiers.RemoveAtSwap(Index, 1, false);
+	LastGravityForces.RemoveAtSwap(Index, 1, false);
+
+	return Components.IsValidIndex(Index) ? Components[Index] : nullptr;
+}
+
+
+void FGravityMovementBatch::Reset()
+{
+	Components.Reset();
+	Planets.Reset();
+	GravityInfos.Reset();
+	Locations.Reset();
+	Rotations.Reset();
+	InterpStartRotations.Reset();
+	DeltaTimes.Reset();
+	InterpSpeeds.Reset();
+	InterpolationModes.Reset();
+	AlignedAngleCosines.Reset();
+	GravityScales.Reset();
+	ApplyGravityFlags.Reset();
+	RotationChangedFlags.Reset();
+	NewRotations.Reset();
+	GravityForces.Reset();
+}
+
+int32 FGravityMovementBatch::Add(UGravityMovementComponent* Component, const APlanetActor* Planet, const FGravityInfo& GravityInfo, const FVector& Location, const FQuat& Rotation,
+	const FQuat& InterpStartRotation, float DeltaTime, float InterpSpeed, EOrientationInterpolationMode::Type InterpolationMode, float AlignedAngleCos, float GravityScale, bool bApplyGravity)
+{
+	Planets.Add(Planet);
+	GravityInfos.Add(GravityInfo);
+	Locations.Add(Location);
+	Rotations.Add(Rotation);
+	InterpStartRotations.Add(InterpStartRotation);
+	DeltaTimes.Add(DeltaTime);
+	InterpSpeeds.Add(InterpSpeed);
+	InterpolationModes.Add(InterpolationMode);
+	AlignedAngleCosines.Add(AlignedAngleCos);
+	GravityScales.Add(GravityScale);
+	ApplyGravityFlags.Add(bApplyGravity);
+	RotationChangedFlags.AddUninitialized();
+	NewRotations.AddUninitialized();
+	GravityForces.AddUninitialized();
+	return Components.Add(Component);
+}
+
+void FGravityMovementBatch::Calculate(bool bParallel)
+{
+	// Same math as the per-component path (UGravityMovementComponent::TickComponent)
+	ParallelFor(Num(), [this](int32 Index)
+	{
+		FGravityInfo& GravityInfo = GravityInfos[Index];
+		if (Planets[Index] != nullptr)
+		{
+			GravityInfo = Planets[Index]->GetGravityinfo(Locations[Index]);
+		}
+
+		RotationChangedFlags[Index] = UGravityMovementComponent::CalcCapsuleRotation(Rotations[Index], InterpStartRotations[Index], -GravityInfo.GravityDirection,
+			DeltaTimes[Index], InterpSpeeds[Index], InterpolationModes[Index], AlignedAngleCosines[Index], NewRotations[Index]);
+
+		GravityForces[Index] = ApplyGravityFlags[Index] ? UGravityMovementComponent::CalcGravityForce(GravityInfo, GravityScales[Index]) : FVector::ZeroVector;
+	}, !bParallel);
+}
+
+
+void FGravityMovementBatchTickFunction::ExecuteTick(float DeltaTime, ELevelTick TickType, ENamedThreads::Type CurrentThread, const FGraphEventRef& MyCompletionGraphEvent)
+{
+	if (Target != nullptr && !Target->IsPendingKill())
+	{
+		Target->UpdateMovementBatch(DeltaTime);
+	}
+}
+
+FString FGravityMovementBatchTickFunction::DiagnosticMessage()
+{
+	return Target ? Target->GetFullName() + TEXT("[MovementBatch]") : TEXT("<invalid>[MovementBatch]");
+}
+
+
+AGravityWorldManager::AGravityWorldManager(const FObjectInitializer& ObjectInitializer) : Super(ObjectInitializer)
+{
+	// Forces must be queued before the physics scene is simulated.
+	PrimaryActorTick.bCanEverTick = true;
+	PrimaryActorTick.bStartWithTickEnabled = true;
+	PrimaryActorTick.TickGroup = TG_PrePhysics;
+
+	// Ticks first in its group, so the global gravity is published before gravity components read it.
+	PrimaryActorTick.bHighPriority = true;
+
+	// Runs after the ticks of the registered Gravity Movement components, before physics
+	MovementBatchTickFunction.bCanEverTick = true;
+	MovementBatchTickFunction.bStartWithTickEnabled = true;
+	MovementBatchTickFunction.TickGroup = TG_PrePhysics;
+}
+
+AGravityWorldManager* AGravityWorldManager::Get(const UObject* WorldContextObject)
+{
+	AGravityWorldManager* GravityManager = Find(WorldContextObject);
+	if (GravityManager != nullptr)
+	{
+		return GravityManager;
+	}
+
+	UWorld* World = GEngine ? GEngine->GetWorldFromContextObject(WorldContextObject, EGetWorldErrorMode::ReturnNull) : nullptr;
+
+	if (World == nullptr || !World->IsGameWorld() || World->bIsTearingDown)
+	{
+		return nullptr;
+	}
+
+	FActorSpawnParameters SpawnInfo;
+	SpawnInfo.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+	SpawnInfo.ObjectFlags |= RF_Transient;	// Never saved into a map
+
+	return World->SpawnActor<AGravityWorldManager>(SpawnInfo);
+}
+
+AGravityWorldManager* AGravityWorldManager::Find(const UObject* WorldContextObject)
+{
+	UWorld* World = GEngine ? GEngine->GetWorldFromContextObject(WorldContextObject, EGetWorldErrorMode::ReturnNull) : nullptr;
+
+	if (World == nullptr || !World->IsGameWorld())
+	{
+		return nullptr;
+	}
+
+	for (TActorIterator<AGravityWorldManager> It(World); It; ++It)
+	{
+		if (!It->IsPendingKill())
+		{
+			return *It;
+		}
+	}
+
+	return nullptr;
+}
+
+void AGravityWorldManager::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	for (FGravityComponentBatch& Batch : GravityBatches)
+	{
+		for (UCustomGravityComponent* Component : Batch.Components)
+		{
+			Component->GravityManager.Reset();
+			Component->GravityBatchIndex = INDEX_NONE;
+		}
+
+		Batch = FGravityComponentBatch();
+	}
+
+	for (UGravityMovementComponent* Component : MovementComponents)
+	{
+		Component->bUseMovementBatch = false;
+		Component->GravityManager.Reset();
+
+		if (USkeletalMeshComponent* PawnMesh = GetBatchedPawnMesh(Component))
+		{
+			PawnMesh->PrimaryComponentTick.RemovePrerequisite(this, MovementBatchTickFunction);
+		}
+	}
+
+	MovementComponents.Reset();
+	MovementBatch.Reset();
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void AGravityWorldManager::RegisterActorTickFunctions(bool bRegister)
+{
+	Super::RegisterActorTickFunctions(bRegister);
+
+	if (bRegister)
+	{
+		if (MovementBatchTickFunction.bCanEverTick)
+		{
+			MovementBatchTickFunction.Target = this;
+			MovementBatchTickFunction.SetTickFunctionEnable(MovementBatchTickFunction.bStartWithTickEnabled);
+			MovementBatchTickFunction.RegisterTickFunction(GetLevel());
+		}
+	}
+	else if (MovementBatchTickFunction.IsTickFunctionRegistered())
+	{
+		MovementBatchTickFunction.UnRegisterTickFunction();
+	}
+}
+
+void AGravityWorldManager::Tick(float DeltaSeconds)
+{
+	SCOPE_CUSTOM_GRAVITY_TICK_TIMER();
+
+	Super::Tick(DeltaSeconds);
+
+	PublishGlobalGravity();
+
+	PlanetRegistry.Update();
+
+	const bool bSignificanceUpdated = SignificanceManager.Update(GetWorld(), DeltaSeconds);
+	if (bSignificanceUpdated || FGravitySignificanceManager::ShouldDrawDebug())
+	{
+		UpdateGravityComponentsSignificance(!bSignificanceUpdated);
+	}
+
+	UpdateGravityComponents(DeltaSeconds);
+
+	// Once per frame for all the Gravity Movement Components
+	const uint64 NumGroundQueries = GCustomGravityCachedGroundContacts + GCustomGravityGroundSweeps;
+	if (NumGroundQueries > 0)
+	{
+		SET_FLOAT_STAT(STAT_GroundSweepsSavedPercent, 100.0 * GCustomGravityCachedGroundContacts / NumGroundQueries);
+	}
+}
+
+void AGravityWorldManager::RegisterGravityComponent(UCustomGravityComponent* Component)
+{
+	if (Component == nullptr || Component->GravityBatchIndex != INDEX_NONE)
+	{
+		return;
+	}
+
+	const EGravityType::Type GravityType = Component->GravityType;
+
+	Component->GravityManager = this;
+	Component->BatchedGravityType = GravityType;
+	Component->GravityBatchIndex = GravityBatches[GravityType].Add(Component, Component->UpdatedComponent, Component->GravityScale);
+}
+
+void AGravityWorldManager::UnregisterGravityComponent(UCustomGravityComponent* Component)
+{
+	if (Component == nullptr || Component->GravityBatchIndex == INDEX_NONE)
+	{
+		return;
+	}
+
+	FGravityComponentBatch& Batch = GravityBatches[Component->BatchedGravityType];
+	check(Batch.Components[Component->GravityBatchIndex] == Component);
+
+	UCustomGravityComponent* MovedComponent = Batch.RemoveAtSwap(Component->GravityBatchIndex);
+	if (MovedComponent != nullptr)
+	{
+		MovedComponent->GravityBatchIndex = Component->GravityBatchIndex;
+	}
+
+	Component->GravityBatchIndex = INDEX_NONE;
+}
+
+void AGravityWorldManager::RefreshGravityComponent(UCustomGravityComponent* Component)
+{
+	if (Component == nullptr || Component->GravityBatchIndex == INDEX_NONE)
+	{
+		return;
+	}
+
+	// Gravity type changed : move the component to its new batch
+	if (Component->BatchedGravityType != Component->GravityType)
+	{
+		UnregisterGravityComponent(Component);
+		RegisterGravityComponent(Component);
+		return;
+	}
+
+	FGravityComponentBatch& Batch = GravityBatches[Component->BatchedGravityType];
+	Batch.UpdatedComponents[Component->GravityBatchIndex] = Component->UpdatedComponent;
+	Batch.GravityScales[Component->GravityBatchIndex] = Component->GravityScale;
+
+	// Evaluated again on the next update, until the next ranking
+	Batch.SignificanceTiers[Component->GravityBatchIndex] = EGravitySignificance::EGS_High;
+}
+
+void AGravityWorldManager::RegisterMovementComponent(UGravityMovementComponent* Component)
+{
+	if (Component == nullptr || Component->bUseMovementBatch)
+	{
+		return;
+	}
+
+	Component->GravityManager = this;
+	Component->bUseMovementBatch = true;
+	MovementComponents.Add(Component);
+	MovementBatchTickFunction.AddPrerequisite(Component, Component->PrimaryComponentTick);
+
+	// The batched pass writes the capsule rotation : the mesh has to tick after it, not only after the component
+	if (USkeletalMeshComponent* PawnMesh = GetBatchedPawnMesh(Component))
+	{
+		PawnMesh->PrimaryComponentTick.AddPrerequisite(this, MovementBatchTickFunction);
+	}
+}
+
+USkeletalMeshComponent* AGravityWorldManager::GetBatchedPawnMesh(const UGravityMovementComponent* Component)
+{
+	const AGravityPawn* GravityPawn = Cast<AGravityPawn>(Component->GetOwner());
+	USkeletalMeshComponent* PawnMesh = GravityPawn != nullptr ? GravityPawn->GetMesh() : nullptr;
+
+	return (PawnMesh != nullptr && PawnMesh->PrimaryComponentTick.bCanEverTick) ? PawnMesh : nullptr;
+}
+
+void AGravityWorldManager::UnregisterMovementComponent(UGravityMovementComponent* Component)
+{
+	if (Component == nullptr || !Component->bUseMovementBatch)
+	{
+		return;
+	}
+
+	Component->bUseMovementBatch = false;
+	MovementComponents.RemoveSingleSwap(Component, false);
+	MovementBatchTickFunction.RemovePrerequisite(Component, Component->PrimaryComponentTick);
+
+	if (USkeletalMeshComponent* PawnMesh = GetBatchedPawnMesh(Component))
+	{
+		PawnMesh->PrimaryComponentTick.RemovePrerequisite(this, MovementBatchTickFunction);
+	}
+
+	// Already queued this frame
+	for (UGravityMovementComponent*& QueuedComponent : MovementBatch.Components)
+	{
+		if (QueuedComponent == Component)
+		{
+			QueuedComponent = nullptr;
+		}
+	}
+}
+
+void AGravityWorldManager::QueueMovementUpdate(UGravityMovementComponent* Component, float DeltaTime, float InterpSpeed, const APlanetActor* Planet, bool bApplyGravity)
+{
+	UCapsuleComponent* CapsuleComponent = Component->CapsuleComponent;
+
+	MovementBatch.Add(Component, Planet, Component->CurrentGravityInfo, CapsuleComponent->GetComponentLocation(), CapsuleComponent->GetComponentQuat(),
+		Component->CurrentCapsuleQuat, DeltaTime, InterpSpeed, Component->OrientationSettings.InterpolationMode, Component->GetAlignedAngleCos(), Component->GravityScale, bApplyGravity);
+}
+
+void AGravityWorldManager::UpdateMovementBatch(float DeltaTime)
+{
+	SCOPE_CUSTOM_GRAVITY_TICK_TIMER();
+	SCOPE_CYCLE_COUNTER(STAT_GravityMovementBatch);
+	INC_DWORD_STAT_BY(STAT_NumBatchedMovementComponents, MovementBatch.Num());
+
+	if (MovementBatch.Num() == 0)
+	{
+		return;
+	}
+
+	// Pure math, no component is touched
+	MovementBatch.Calculate(MovementBatch.Num() >= MinParallelMovementBatchSize && CVarParallelMovementBatch.GetValueOnGameThread() != 0);
+
+	// Transform and physics writes
+	for (int32 Index = 0; Index < MovementBatch.Num(); ++Index)
+	{
+		UGravityMovementComponent* Component = MovementBatch.Components[Index];
+		if (Component == nullptr)
+		{
+			continue;
+		}
+
+		Component->ApplyMovementBatchResult(MovementBatch.RotationChangedFlags[Index], MovementBatch.NewRotations[Index], MovementBatch.Planets[Index] ? &MovementBatch.GravityInfos[Index] : nullptr,
+			MovementBatch.GravityForces[Index], MovementBatch.ApplyGravityFlags[Index]);
+	}
+
+	MovementBatch.Reset();
+}
+
+void AGravityWorldManager::SetGlobalGravityInfo(const FGravityInfo& NewGravityInfo)
+{
+	PendingGlobalGravity.GravityInfo = NewGravityInfo;
+	PendingGlobalGravity.GravityInfo.GravityDirection = NewGravityInfo.GravityDirection.GetSafeNormal();
+	PendingGlobalGravity.GravityForce = PendingGlobalGravity.GravityInfo.GravityDirection * PendingGlobalGravity.GravityInfo.GravityPower;
+	++PendingGlobalGravity.Version;
+}
+
+void AGravityWorldManager::PublishGlobalGravity()
+{
+	const int32 PublishedIndex = PublishedGlobalGravityIndex.GetValue();
+	if (GlobalGravitySnapshots[PublishedIndex].Version == PendingGlobalGravity.Version)
+	{
+		return;
+	}
+
+	// Readers of the previous frame are done with the back snapshot
+	const int32 BackIndex = 1 - PublishedIndex;
+	GlobalGravitySnapshots[BackIndex] = PendingGlobalGravity;
+	PublishedGlobalGravityIndex.Set(BackIndex);
+
+	WakeGravityComponents(nullptr);
+
+	const FGravityInfo& GravityInfo = GlobalGravitySnapshots[BackIndex].GravityInfo;
+	OnGlobalGravityChanged.Broadcast(GravityInfo);
+	OnGlobalGravityChangedEvent.Broadcast(GravityInfo);
+}
+
+int32 AGravityWorldManager::GetNumGravityComponents() const
+{
+	int32 NumComponents = 0;
+	for (const FGravityComponentBatch& Batch : GravityBatches)
+	{
+		NumComponents += Batch.Num();
+	}
+	return NumComponents;
+}
+
+void AGravityWorldManager::WakeGravityComponents(const APlanetActor* Planet)
+{
+	const EGravityType::Type GravityType = Planet != nullptr ? EGravityType::EGT_Point : EGravityType::EGT_GlobalGravity;
+	UWorld* World = GetWorld();
+
+	// Rare : components ticking on their own are not listed anywhere else
+	for (TObjectIterator<UCustomGravityComponent> It; It; ++It)
+	{
+		UCustomGravityComponent* Component = *It;
+		if (Component->GravityType != GravityType || Component->GetWorld() != World || Component->IsPendingKill())
+		{
+			continue;
+		}
+
+		if (Planet == nullptr || Component->GetCurrentPlanet() == Planet)
+		{
+			Component->WakeUpdatedComponent();
+		}
+	}
+}
+
+void AGravityWorldManager::UpdateGravityComponents(float DeltaTime)
+{
+	SCOPE_CYCLE_COUNTER(STAT_GravityComponentsBatchedUpdate);
+	INC_DWORD_STAT_BY(STAT_NumBatchedGravityComponents, GetNumGravityComponents());
+
+	UpdateDefaultGravityBatch(GravityBatches[EGravityType::EGT_Default]);
+	UpdateCustomGravityBatch(GravityBatches[EGravityType::EGT_Custom]);
+	UpdateGlobalGravityBatch(GravityBatches[EGravityType::EGT_GlobalGravity]);
+	UpdatePointGravityBatch(GravityBatches[EGravityType::EGT_Point]);
+}
+
+void AGravityWorldManager::UpdateGravityComponentsSignificance(bool bDrawOnly)
+{
+	for (FGravityComponentBatch& Batch : GravityBatches)
+	{
+		for (int32 Index = 0; Index < Batch.Num(); ++Index)
+		{
+			UPrimitiveComponent* UpdatedComponent = Batch.UpdatedComponents[Index].Get();
+			if (UpdatedComponent == nullptr)
+			{
+				continue;
+			}
+
+			if (!bDrawOnly)
+			{
+				Batch.SignificanceTiers[Index] = SignificanceManager.Evaluate(UpdatedComponent->GetComponentLocation(), UpdatedComponent->Bounds.SphereRadius, UpdatedComponent->WasRecentlyRendered());
+			}
+
+#if ENABLE_DRAW_DEBUG
+			if (FGravitySignificanceManager::ShouldDrawDebug())
+			{
+				FGravitySignificanceManager::DrawDebugTier(GetWorld(), UpdatedComponent->GetComponentLocation(), UpdatedComponent->Bounds.SphereRadius, Batch.SignificanceTiers[Index]);
+			}
+#endif
+		}
+	}
+}
+
+void AGravityWorldManager::UpdateDefaultGravityBatch(FGravityComponentBatch& Batch)
+{
+	for (int32 Index = 0; Index < Batch.Num(); ++Index)
+	{
+		UPrimitiveComponent* UpdatedComponent = Batch.UpdatedComponents[Index].Get();
+		if (UpdatedComponent == nullptr)
+		{
+			continue;
+		}
+
+		Batch.Components[Index]->UpdateDefaultGravity();
+	}
+}
+
+void AGravityWorldManager::UpdateCustomGravityBatch(FGravityComponentBatch& Batch)
+{
+	for (int32 Index = 0; Index < Batch.Num(); ++Index)
+	{
+		UPrimitiveComponent* UpdatedComponent = Batch.UpdatedComponents[Index].Get();
+		if (UpdatedComponent == nullptr)
+		{
+			continue;
+		}
+
+		UCustomGravityComponent* Component = Batch.Components[Index];
+		const FGravityInfo& GravityInfo = Component->CustomGravityInfo;
+		Component->CurrentGravityInfo = GravityInfo;
+
+		const FVector GravityForce = GravityInfo.GravityDirection.GetSafeNormal() * GravityInfo.GravityPower * Batch.GravityScales[Index];
+		Component->ApplyGravity(GravityForce, GravityInfo);
+	}
+}
+
+void AGravityWorldManager::UpdateGlobalGravityBatch(FGravityComponentBatch& Batch)
+{
+	if (Batch.Num() == 0)
+	{
+		return;
+	}
+
+	// Same gravity for the whole batch, its force is computed once per change
+	const FGlobalGravitySnapshot& GlobalGravity = GetGlobalGravitySnapshot();
+	const FGravityInfo& GravityInfo = GlobalGravity.GravityInfo;
+
+	for (int32 Index = 0; Index < Batch.Num(); ++Index)
+	{
+		UPrimitiveComponent* UpdatedComponent = Batch.UpdatedComponents[Index].Get();
+		if (UpdatedComponent == nullptr)
+		{
+			continue;
+		}
+
+		UCustomGravityComponent* Component = Batch.Components[Index];
+		Component->CurrentGravityInfo = GravityInfo;
+
+		const FVector GravityForce = GlobalGravity.GravityForce * Batch.GravityScales[Index];
+		Component->ApplyGravity(GravityForce, GravityInfo);
+	}
+}
+
+void AGravityWorldManager::UpdatePointGravityBatch(FGravityComponentBatch& Batch)
+{
+	if (Batch.Num() == 0)
+	{
+		return;
+	}
+
+	// Find the planet of each body : pinned planet or dominant planet at the body location
+	PointGravityPlanets.Reset();
+	PointGravityPlanetSlots.Reset();
+	PointGravityBodyLocations.SetNumUninitialized(Batch.Num(), false);
+
+	int32 LastPlanetSlot = INDEX_NONE;
+	for (int32 Index = 0; Index < Batch.Num(); ++Index)
+	{
+		UPrimitiveComponent* UpdatedComponent = Batch.UpdatedComponents[Index].Get();
+		if (UpdatedComponent == nullptr)
+		{
+			PointGravityPlanetSlots.Add(INDEX_NONE);
+			continue;
+		}
+
+		UCustomGravityComponent* Component = Batch.Components[Index];
+
+		// Reduced significance : the gravity evaluated on a previous frame is applied again, frames are staggered over the batch
+		const uint32 UpdateFrames = FGravitySignificanceManager::GetGravityUpdateFrames(Batch.SignificanceTiers[Index]);
+		if (UpdateFrames > 1 && !Component->bApplyGravityInSubsteps && (GFrameCounter + Index) % UpdateFrames != 0)
+		{
+			INC_DWORD_STAT(STAT_NumSignificanceGravityUpdatesSkipped);
+			if (!Batch.LastGravityForces[Index].IsZero())
+			{
+				Component->ApplyGravity(Batch.LastGravityForces[Index], Component->CurrentGravityInfo);
+			}
+			PointGravityPlanetSlots.Add(INDEX_NONE);
+			continue;
+		}
+
+		PointGravityBodyLocations[Index] = UpdatedComponent->GetComponentLocation();
+
+		APlanetActor* Planet = Component->ResolvePlanet(PointGravityBodyLocations[Index]);
+		if (Planet == nullptr)
+		{
+			Batch.LastGravityForces[Index] = FVector::ZeroVector;
+			PointGravityPlanetSlots.Add(INDEX_NONE);
+			continue;
+		}
+
+		// Evaluated in the physics substeps, at the substep body location
+		if (Component->bApplyGravityInSubsteps)
+		{
+			Component->CurrentGravityInfo = Planet->GetGravityinfo(PointGravityBodyLocations[Index]);
+			Component->QueueSubstepGravity(Planet);
+			PointGravityPlanetSlots.Add(INDEX_NONE);
+			continue;
+		}
+
+		if (LastPlanetSlot == INDEX_NONE || PointGravityPlanets[LastPlanetSlot] != Planet)
+		{
+			LastPlanetSlot = PointGravityPlanets.AddUnique(Planet);
+		}
+		PointGravityPlanetSlots.Add(LastPlanetSlot);
+	}
+
+	const int32 NumPlanets = PointGravityPlanets.Num();
+	if (NumPlanets == 0)
+	{
+		return;
+	}
+
+	// Counting sort of the bodies by planet
+	PointGravityPlanetOffsets.Reset();
+	PointGravityPlanetOffsets.AddZeroed(NumPlanets + 1);
+	for (const int32 PlanetSlot : PointGravityPlanetSlots)
+	{
+		if (PlanetSlot != INDEX_NONE)
+		{
+			++PointGravityPlanetOffsets[PlanetSlot + 1];
+		}
+	}
+	for (int32 PlanetSlot = 0; PlanetSlot < NumPlanets; ++PlanetSlot)
+	{
+		PointGravityPlanetOffsets[PlanetSlot + 1] += PointGravityPlanetOffsets[PlanetSlot];
+	}
+
+	const int32 NumBodies = PointGravityPlanetOffsets[NumPlanets];
+	PointGravitySortedIndices.SetNumUninitialized(NumBodies, false);
+	PointGravityLocations.SetNumUninitialized(NumBodies, false);
+	PointGravityDirections.SetNumUninitialized(NumBodies, false);
+	PointGravityPowers.SetNumUninitialized(NumBodies, false);
+
+	for (int32 Index = 0; Index < Batch.Num(); ++Index)
+	{
+		const int32 PlanetSlot = PointGravityPlanetSlots[Index];
+		if (PlanetSlot != INDEX_NONE)
+		{
+			// PointGravityPlanetOffsets[PlanetSlot] is used as write cursor, it ends up at the start of the next planet range
+			const int32 SortedIndex = PointGravityPlanetOffsets[PlanetSlot]++;
+			PointGravitySortedIndices[SortedIndex] = Index;
+			PointGravityLocations[SortedIndex] = PointGravityBodyLocations[Index];
+		}
+	}
+
+	// One batched evaluation per planet
+	int32 RangeStart = 0;
+	for (int32 PlanetSlot = 0; PlanetSlot < NumPlanets; ++PlanetSlot)
+	{
+		const int32 RangeEnd = PointGravityPlanetOffsets[PlanetSlot];
+		APlanetActor* Planet = PointGravityPlanets[PlanetSlot];
+
+		Planet->GetGravityInfoBatch(&PointGravityLocations[RangeStart], RangeEnd - RangeStart, &PointGravityDirections[RangeStart], &PointGravityPowers[RangeStart]);
+
+		for (int32 SortedIndex = RangeStart; SortedIndex < RangeEnd; ++SortedIndex)
+		{
+			const int32 Index = PointGravitySortedIndices[SortedIndex];
+			const FGravityInfo GravityInfo(PointGravityPowers[SortedIndex], PointGravityDirections[SortedIndex], Planet->ForceMode, Planet->bShouldUseStepping);
+			UCustomGravityComponent* Component = Batch.Components[Index];
+			Component->CurrentGravityInfo = GravityInfo;
+
+			// Directions are already normalized
+			const FVector GravityForce = GravityInfo.GravityDirection * GravityInfo.GravityPower * Batch.GravityScales[Index];
+			Component->ApplyGravity(GravityForce, GravityInfo);
+			Batch.LastGravityForces[Index] = GravityForce;
+		}
+
+		RangeStart = RangeEnd;
+	}
+}
@@ -41,6 +41,15 @@ APlanetActor::APlanetActor(const FObjectInitializer& Objectinititializer) :Super
 	ForceMode = EForceMode::EFM_Acceleration;
 	GravityPower = 980.0f;
 	bShouldUseStepping = true;
+	SphereOfInfluenceRadius = 0.0f;
+	GravityField = nullptr;
+
+	GravityFalloff = EGravityFalloff::EGF_Constant;
+	FalloffStartDistance = 1000.0f;
+	FalloffRadius = 10000.0f;
+	FalloffCurve = nullptr;
+	FalloffTableResolution = 256;
+	bFalloffTableDirty = true;
 
 	bSphereCollisionIsSelected = (CollisionType == ECollisionType::ECol_Sphere);
 }
@@ -52,12 +61,57 @@ void APlanetActor::PostInitializeComponents()
 	Initialization();
 }
 
+void APlanetActor::BeginPlay()
+{
+	Super::BeginPlay();
+
+	if (GravityField != nullptr)
+	{
+		GravityField->LoadField();
+	}
+
+	AGravityWorldManager* GravityManager = AGravityWorldManager::Get(this);
+	if (GravityManager != nullptr)
+	{
+		GravityManager->GetPlanetRegistry().AddPlanet(this);
+	}
+}
+
+void APlanetActor::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	AGravityWorldManager* GravityManager = AGravityWorldManager::Find(this);
+	if (GravityManager != nullptr)
+	{
+		GravityManager->GetPlanetRegistry().RemovePlanet(this);
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
 #if WITH_EDITOR
 
 void APlanetActor::PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent)
 {
 	Super::PostEditChangeProperty(PropertyChangedEvent);
 
+	const FName PropertyName = PropertyChangedEvent.GetPropertyName();
+
+	if (PropertyName == GET_MEMBER_NAME_CHECKED(APlanetActor, GravityFalloff) ||
+		PropertyName == GET_MEMBER_NAME_CHECKED(APlanetActor, FalloffStartDistance) ||
+		PropertyName == GET_MEMBER_NAME_CHECKED(APlanetActor, FalloffRadius) ||
+		PropertyName == GET_MEMBER_NAME_CHECKED(APlanetActor, FalloffCurve) ||
+		PropertyName == GET_MEMBER_NAME_CHECKED(APlanetActor, FalloffTableResolution) ||
+		PropertyName == GET_MEMBER_NAME_CHECKED(APlanetActor, SphereCollisionRaduis) ||
+		PropertyName == GET_MEMBER_NAME_CHECKED(APlanetActor, CollisionType))
+	{
+		if (GravityFalloff == EGravityFalloff::EGF_InverseSquare)
+		{
+			FalloffStartDistance = FMath::Max(FalloffStartDistance, GetMinInverseSquareStartDistance());
+		}
+
+		bFalloffTableDirty = true;
+	}
+
 	Initialization();
 }
 
@@ -96,18 +150,167 @@ void APlanetActor::Initialization()
 	}
 
 	MeshComponent->SetRelativeScale3D(PlanetMeshScale);
+
+	if (bFalloffTableDirty)
+	{
+		BuildFalloffTable();
+	}
+}
+
+
+void APlanetActor::BuildFalloffTable()
+{
+	bFalloffTableDirty = false;
+	FalloffTable.Reset();
+
+	if (GravityFalloff == EGravityFalloff::EGF_Constant || FalloffRadius <= 0.0f)
+	{
+		return;
+	}
+
+	const int32 NumSamples = FMath::Max(FalloffTableResolution, 2);
+	float StartDistance = FMath::Min(FalloffStartDistance, FalloffRadius);
+	if (GravityFalloff == EGravityFalloff::EGF_InverseSquare)
+	{
+		StartDistance = FMath::Max(StartDistance, GetMinInverseSquareStartDistance());
+	}
+	const float FalloffRange = FalloffRadius - StartDistance;
+
+	TSharedRef<FGravityFalloffTable, ESPMode::ThreadSafe> NewTable = MakeShared<FGravityFalloffTable, ESPMode::ThreadSafe>();
+	NewTable->Multipliers.SetNumUninitialized(NumSamples);
+	NewTable->Scale = (NumSamples - 1) / FalloffRadius;
+
+	for (int32 Index = 0; Index < NumSamples; ++Index)
+	{
+		const float Distance = Index / NewTable->Scale;
+		float Multiplier = 1.0f;
+
+		if (Distance > StartDistance)
+		{
+			const float Alpha = FalloffRange > 0.0f ? (Distance - StartDistance) / FalloffRange : 1.0f;
+
+			switch (GravityFalloff)
+			{
+			case EGravityFalloff::EGF_InverseSquare:
+				Multiplier = FMath::Square(StartDistance / Distance);
+				break;
+			case EGravityFalloff::EGF_Linear:
+				Multiplier = 1.0f - Alpha;
+				break;
+			case EGravityFalloff::EGF_Curve:
+				Multiplier = FalloffCurve != nullptr ? FalloffCurve->GetFloatValue(Alpha) : 1.0f;
+				break;
+			default:
+				break;
+			}
+		}
+
+		NewTable->Multipliers[Index] = Multiplier;
+	}
+
+	FalloffTable = NewTable;
+}
+
+
+float APlanetActor::GetMinInverseSquareStartDistance() const
+{
+	const float SurfaceDistance = (CollisionType == ECollisionType::ECol_Sphere) ? SphereCollisionRaduis : 0.0f;
+	return FMath::Max(SurfaceDistance, 1.0f);
+}
+
+
+void APlanetActor::RebuildFalloffTable()
+{
+	BuildFalloffTable();
+	WakeAttractedBodies();
+}
+
+
+float FGravityFalloffTable::GetMultiplier(float Distance) const
+{
+	const float TablePosition = Distance * Scale;
+	const int32 LastIndex = Multipliers.Num() - 1;
+
+	if (TablePosition >= LastIndex)
+	{
+		// No gravity beyond FalloffRadius
+		return 0.0f;
+	}
+
+	const int32 Index = FMath::Max(FMath::FloorToInt(TablePosition), 0);
+	const float Alpha = TablePosition - Index;
+
+	return FMath::Lerp(Multipliers[Index], Multipliers[Index + 1], Alpha);
+}
+
+
+float APlanetActor::GetGravityPowerAtDistance(float Distance) const
+{
+	return FalloffTable.IsValid() ? GravityPower * FalloffTable->GetMultiplier(Distance) : GravityPower;
 }
 
 
 FVector APlanetActor::GetGravityDirection(const FVector& TargetLocation) const
 {
-	return (GetActorLocation() - TargetLocation).GetSafeNormal();
+	FVector GravityDirection;
+	float GravityPowerAtTarget;
+	EvaluateGravity(GetActorTransform(), GravityPower, FalloffTable.Get(), UsesGravityField() ? GravityField : nullptr, TargetLocation, GravityDirection, GravityPowerAtTarget);
+
+	return GravityDirection;
+}
+
+
+void APlanetActor::EvaluateGravity(const FTransform& PlanetTransform, float InGravityPower, const FGravityFalloffTable* InFalloffTable, const UGravityFieldAsset* InGravityField,
+	const FVector& TargetLocation, FVector& OutGravityDirection, float& OutGravityPower)
+{
+	const FVector Delta = PlanetTransform.GetLocation() - TargetLocation;
+	const float Distance = Delta.Size();
+
+	OutGravityPower = InFalloffTable != nullptr ? InGravityPower * InFalloffTable->GetMultiplier(Distance) : InGravityPower;
+	OutGravityDirection = Distance > SMALL_NUMBER ? Delta / Distance : FVector::ZeroVector;
+
+	if (InGravityField != nullptr)
+	{
+		FVector LocalGravityDirection;
+		if (InGravityField->SampleGravityDirection(PlanetTransform.InverseTransformPosition(TargetLocation), LocalGravityDirection))
+		{
+			OutGravityDirection = PlanetTransform.TransformVectorNoScale(LocalGravityDirection);
+		}
+	}
+}
+
+
+bool APlanetActor::UsesGravityField() const
+{
+	return CollisionType == ECollisionType::ECol_Mesh && GravityField != nullptr && GravityField->IsFieldLoaded();
+}
+
+
+void APlanetActor::BakeGravityField()
+{
+#if WITH_EDITOR
+	if (GravityField == nullptr)
+	{
+		UE_LOG(LogCustomGravity, Warning, TEXT("%s : no gravity field asset to bake into."), *GetName());
+		return;
+	}
+
+	if (CollisionType != ECollisionType::ECol_Mesh || MeshComponent->GetStaticMesh() == nullptr)
+	{
+		UE_LOG(LogCustomGravity, Warning, TEXT("%s : gravity fields are only baked for mesh collision planets."), *GetName());
+		return;
+	}
+
+	GravityField->Modify();
+	GravityField->Bake(MeshComponent, GetActorTransform(), MeshComponent->CalcBounds(MeshComponent->GetRelativeTransform()).GetBox());
+#endif // WITH_EDITOR
 }
 
 
 void  APlanetActor::SetGravityPower(float NewGravity)
 {
 	GravityPower = NewGravity;
+	WakeAttractedBodies();
 }
 
 
@@ -115,6 +318,39 @@ void  APlanetActor::SetGravityPower(float NewGravity)
 void APlanetActor::SetForceMode(EForceMode::Type newForceMode)
 {
 	ForceMode = newForceMode;
+	WakeAttractedBodies();
+}
+
+void APlanetActor::WakeAttractedBodies()
+{
+	AGravityWorldManager* GravityManager = AGravityWorldManager::Find(this);
+	if (GravityManager != nullptr)
+	{
+		GravityManager->WakeGravityComponents(this);
+	}
+}
+
+void APlanetActor::SetSphereOfInfluenceRadius(float NewRadius)
+{
+	SphereOfInfluenceRadius = FMath::Max(NewRadius, 0.0f);
+}
+
+float APlanetActor::GetInfluence(const FVector& TargetLocation, float RadiusScale) const
+{
+	const float Radius = SphereOfInfluenceRadius * RadiusScale;
+	if (Radius <= 0.0f)
+	{
+		return 0.0f;
+	}
+
+	const float DistanceSquared = FVector::DistSquared(GetActorLocation(), TargetLocation);
+	if (DistanceSquared >= FMath::Square(Radius))
+	{
+		return 0.0f;
+	}
+
+	const float Distance = FMath::Sqrt(DistanceSquared);
+	return GetGravityPowerAtDistance(Distance) * (1.0f - Distance / Radius);
 }
 
 FGravityInfo APlanetActor::GetGravityinfo(const FVector& TargetLocation) const
@@ -122,9 +358,161 @@ FGravityInfo APlanetActor::GetGravityinfo(const FVector& TargetLocation) const
 	FGravityInfo GravInfo;
 	GravInfo.bForceSubStepping = bShouldUseStepping;
 	GravInfo.ForceMode = ForceMode;
-	GravInfo.GravityPower = GravityPower;
-	GravInfo.GravityDirection = GetGravityDirection(TargetLocation);
+	EvaluateGravity(GetActorTransform(), GravityPower, FalloffTable.Get(), UsesGravityField() ? GravityField : nullptr, TargetLocation, GravInfo.GravityDirection, GravInfo.GravityPower);
 
 	return GravInfo;
 }
 
+void APlanetActor::GetGravityInfoBatch(const TArray<FVector>& TargetLocations, TArray<FVector>& OutGravityDirections, TArray<float>& OutGravityPowers) const
+{
+	const int32 NumLocations = TargetLocations.Num();
+	OutGravityDirections.SetNumUninitialized(NumLocations, false);
+	OutGravityPowers.SetNumUninitialized(NumLocations, false);
+
+	GetGravityInfoBatch(TargetLocations.GetData(), NumLocations, OutGravityDirections.GetData(), OutGravityPowers.GetData());
+}
+
+void APlanetActor::GetGravityInfoBatch(const FVector* TargetLocations, int32 NumLocations, FVector* OutGravityDirections, float* OutGravityPowers) const
+{
+	if (!FalloffTable.IsValid())
+	{
+		ComputePointGravityDirections(GetActorLocation(), TargetLocations, NumLocations, OutGravityDirections);
+
+		for (int32 Index = 0; Index < NumLocations; ++Index)
+		{
+			OutGravityPowers[Index] = GravityPower;
+		}
+	}
+	else
+	{
+		// Distances are written to the power array, then replaced by the gravity power at that distance
+		ComputePointGravityDirections(GetActorLocation(), TargetLocations, NumLocations, OutGravityDirections, OutGravityPowers);
+
+		for (int32 Index = 0; Index < NumLocations; ++Index)
+		{
+			OutGravityPowers[Index] = GravityPower * FalloffTable->GetMultiplier(OutGravityPowers[Index]);
+		}
+	}
+
+	if (UsesGravityField())
+	{
+		// Point gravity directions are kept outside the baked bricks
+		const FTransform& ActorTransform = GetActorTransform();
+
+		for (int32 Index = 0; Index < NumLocations; ++Index)
+		{
+			FVector LocalGravityDirection;
+			if (GravityField->SampleGravityDirection(ActorTransform.InverseTransformPosition(TargetLocations[Index]), LocalGravityDirection))
+			{
+				OutGravityDirections[Index] = ActorTransform.TransformVectorNoScale(LocalGravityDirection);
+			}
+		}
+	}
+}
+
+void APlanetActor::ComputePointGravityDirections(const FVector& PlanetLocation, const FVector* TargetLocations, int32 NumLocations, FVector* OutGravityDirections, float* OutDistances)
+{
+	const VectorRegister PlanetX = VectorSetFloat1(PlanetLocation.X);
+	const VectorRegister PlanetY = VectorSetFloat1(PlanetLocation.Y);
+	const VectorRegister PlanetZ = VectorSetFloat1(PlanetLocation.Z);
+	const VectorRegister Tolerance = VectorSetFloat1(SMALL_NUMBER);
+	const VectorRegister Zero = VectorZero();
+
+	const int32 NumPackedLocations = NumLocations & ~3;
+	int32 Index = 0;
+
+	for (; Index < NumPackedLocations; Index += 4)
+	{
+		// 4 FVectors are 3 registers : (x0 y0 z0 x1) (y1 z1 x2 y2) (z2 x3 y3 z3)
+		const float* Src = &TargetLocations[Index].X;
+		const VectorRegister A = VectorLoad(Src);
+		const VectorRegister B = VectorLoad(Src + 4);
+		const VectorRegister C = VectorLoad(Src + 8);
+
+		// Transpose to (x0 x1 x2 x3) (y0 y1 y2 y3) (z0 z1 z2 z3)
+		const VectorRegister X = VectorShuffle(A, VectorShuffle(B, C, 2, 2, 1, 1), 0, 3, 0, 2);
+		const VectorRegister Y = VectorShuffle(VectorShuffle(A, B, 1, 1, 0, 0), VectorShuffle(B, C, 3, 3, 2, 2), 0, 2, 0, 2);
+		const VectorRegister Z = VectorShuffle(VectorShuffle(A, B, 2, 2, 1, 1), VectorShuffle(C, C, 0, 0, 3, 3), 0, 2, 0, 2);
+
+		// Planet location - Target location
+		const VectorRegister DeltaX = VectorSubtract(PlanetX, X);
+		const VectorRegister DeltaY = VectorSubtract(PlanetY, Y);
+		const VectorRegister DeltaZ = VectorSubtract(PlanetZ, Z);
+
+		// Safe normalization : zero vector when the squared length is below SMALL_NUMBER (same as FVector::GetSafeNormal)
+		const VectorRegister SizeSquared = VectorMultiplyAdd(DeltaX, DeltaX, VectorMultiplyAdd(DeltaY, DeltaY, VectorMultiply(DeltaZ, DeltaZ)));
+		const VectorRegister InvSize = VectorSelect(VectorCompareGT(SizeSquared, Tolerance), VectorReciprocalSqrtAccurate(SizeSquared), Zero);
+
+		const VectorRegister DirX = VectorMultiply(DeltaX, InvSize);
+		const VectorRegister DirY = VectorMultiply(DeltaY, InvSize);
+		const VectorRegister DirZ = VectorMultiply(DeltaZ, InvSize);
+
+		// Transpose back to 4 FVectors
+		float* Dst = &OutGravityDirections[Index].X;
+		VectorStore(VectorShuffle(VectorShuffle(DirX, DirY, 0, 0, 0, 0), VectorShuffle(DirZ, DirX, 0, 0, 1, 1), 0, 2, 0, 2), Dst);
+		VectorStore(VectorShuffle(VectorShuffle(DirY, DirZ, 1, 1, 1, 1), VectorShuffle(DirX, DirY, 2, 2, 2, 2), 0, 2, 0, 2), Dst + 4);
+		VectorStore(VectorShuffle(VectorShuffle(DirZ, DirX, 2, 2, 3, 3), VectorShuffle(DirY, DirZ, 3, 3, 3, 3), 0, 2, 0, 2), Dst + 8);
+
+		if (OutDistances != nullptr)
+		{
+			VectorStore(VectorMultiply(SizeSquared, InvSize), OutDistances + Index);
+		}
+	}
+
+	// Remaining locations
+	for (; Index < NumLocations; ++Index)
+	{
+		const FVector Delta = PlanetLocation - TargetLocations[Index];
+		OutGravityDirections[Index] = Delta.GetSafeNormal();
+
+		if (OutDistances != nullptr)
+		{
+			OutDistances[Index] = Delta.Size();
+		}
+	}
+}
+
+
+FSubstepPointGravity::FSubstepPointGravity()
+	: bHasPlanet(false)
+	, GravityPower(0.0f)
+	, ForceMode(EForceMode::EFM_Acceleration)
+	, GravityField(nullptr)
+	, GravityScale(1.0f)
+{
+}
+
+void FSubstepPointGravity::Capture(const APlanetActor* NewPlanet, float NewGravityScale)
+{
+	bHasPlanet = (NewPlanet != nullptr);
+	GravityScale = NewGravityScale;
+
+	if (!bHasPlanet)
+	{
+		FalloffTable.Reset();
+		GravityField = nullptr;
+		return;
+	}
+
+	PlanetTransform = NewPlanet->GetActorTransform();
+	GravityPower = NewPlanet->GravityPower;
+	ForceMode = NewPlanet->ForceMode;
+	FalloffTable = NewPlanet->GetFalloffTable();
+	GravityField = NewPlanet->UsesGravityField() ? NewPlanet->GravityField : nullptr;
+}
+
+void FSubstepPointGravity::Apply(FBodyInstance* BodyInstance) const
+{
+	if (!bHasPlanet || BodyInstance == nullptr)
+	{
+		return;
+	}
+
+	FVector GravityDirection;
+	float GravityPowerAtBody;
+	APlanetActor::EvaluateGravity(PlanetTransform, GravityPower, FalloffTable.Get(), GravityField, BodyInstance->GetUnrealWorldTransform_AssumesLocked().GetLocation(), GravityDirection, GravityPowerAtBody);
+
+	// Already inside the substep : the force is applied to this substep only
+	const bool bAccelChange = (ForceMode == EForceMode::EFM_Acceleration);
+	BodyInstance->AddForce(GravityDirection * GravityPowerAtBody * GravityScale, false, bAccelChange);
+}
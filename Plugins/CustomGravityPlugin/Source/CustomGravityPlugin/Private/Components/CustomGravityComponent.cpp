@@ -1,11 +1,25 @@
 #include "CustomGravityPluginPrivatePCH.h"
 #include "Kismet/KismetSystemLibrary.h"
 
+#if WITH_PHYSX
+#include "PhysXPublic.h"
+#include "Physics/PhysicsInterfaceCore.h"
+#endif // WITH_PHYSX
+
+static TAutoConsoleVariable<int32> CVarBatchedGravityUpdate(
+	TEXT("CustomGravity.BatchedUpdate"),
+	1,
+	TEXT("0 : every Custom Gravity component ticks on its own.\n")
+	TEXT("1 : Custom Gravity components are updated in one pass by the world gravity manager (default).\n")
+	TEXT("Read when a component is initialized."),
+	ECVF_Default);
+
 // Sets default values for this component's properties
 UCustomGravityComponent::UCustomGravityComponent()
 {
 	// Set this component to be initialized when the game starts, and to be ticked every frame.  You can turn these features
 	// off to improve performance if you don't need them.
+	// Ticking is disabled in InitializeComponent when the component is updated by the world gravity manager.
 	PrimaryComponentTick.bCanEverTick = true;
 
 	// InitializeComponent virtual void can be called
@@ -17,6 +31,22 @@ UCustomGravityComponent::UCustomGravityComponent()
 	GravityType = EGravityType::EGT_Default;
 	CustomGravityInfo = FGravityInfo();
 	PlanetActor = nullptr;
+	PlanetSelectionHysteresis = 0.1f;
+	bApplyGravityInSubsteps = false;
+	bSkipGravityWhileSleeping = false;
+
+	GravityBatchIndex = INDEX_NONE;
+	bUseGravityBatch = false;
+	BatchedGravityType = EGravityType::EGT_Default;
+	LastGravityForce = FVector::ZeroVector;
+	RestingGravityForce = FVector::ZeroVector;
+	bRestingGravityAccelChange = true;
+	bHasLastGravityForce = false;
+	GlobalGravityVersion = 0;
+	GlobalGravityForce = FVector::ZeroVector;
+
+	OnCalculateSubstepGravity.BindUObject(this, &UCustomGravityComponent::CalculateSubstepGravity);
+	OnApplyRestingGravity.BindUObject(this, &UCustomGravityComponent::ApplyRestingGravity);
 }
 
 
@@ -25,22 +55,85 @@ void UCustomGravityComponent::InitializeComponent()
 {
 	Super::InitializeComponent();
 
-	if (UpdatedComponent != NULL)
+	if (UpdatedComponent == NULL)
+	{
+		UpdatedComponent = GetOwner()->FindComponentByClass<UPrimitiveComponent>();
+		CurrentGravityInfo = FGravityInfo();
+	}
+
+	GravityManager = AGravityWorldManager::Get(this);
+
+	if (GravityManager.IsValid() && CVarBatchedGravityUpdate.GetValueOnGameThread() != 0)
+	{
+		// Moves the tick of an active component to the batch, an inactive component joins it when activated
+		bUseGravityBatch = true;
+		SetComponentTickEnabled(IsActive() && PrimaryComponentTick.bStartWithTickEnabled);
+	}
+}
+
+
+void UCustomGravityComponent::UninitializeComponent()
+{
+	if (GravityManager.IsValid())
+	{
+		GravityManager->UnregisterGravityComponent(this);
+		GravityManager.Reset();
+	}
+	bUseGravityBatch = false;
+
+	Super::UninitializeComponent();
+}
+
+
+void UCustomGravityComponent::SetComponentTickEnabled(bool bEnabled)
+{
+	if (bUseGravityBatch && GravityManager.IsValid())
 	{
+		// Updated by the batch only while ticking is wanted, never by both the batch and the tick
+		if (bEnabled)
+		{
+			GravityManager->RegisterGravityComponent(this);
+		}
+		else
+		{
+			GravityManager->UnregisterGravityComponent(this);
+		}
+
+		Super::SetComponentTickEnabled(false);
 		return;
 	}
 
-	UpdatedComponent = GetOwner()->FindComponentByClass<UPrimitiveComponent>();
-	CurrentGravityInfo = FGravityInfo();
+	Super::SetComponentTickEnabled(bEnabled);
+}
+
+
+void UCustomGravityComponent::RegisterComponentTickFunctions(bool bRegister)
+{
+	Super::RegisterComponentTickFunctions(bRegister);
 
+	// Registering the tick function enables it again (bStartWithTickEnabled)
+	if (bRegister && bUseGravityBatch && GravityManager.IsValid())
+	{
+		PrimaryComponentTick.SetTickFunctionEnable(false);
+	}
 }
 
 
-// Called every frame
+// Called every frame (only when not updated by the world gravity manager)
 void UCustomGravityComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
 {
+	SCOPE_CYCLE_COUNTER(STAT_GravityComponentsTick);
+	SCOPE_CUSTOM_GRAVITY_TICK_TIMER();
+	INC_DWORD_STAT(STAT_NumTickingGravityComponents);
+
 	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
 
+	UpdateGravity();
+}
+
+
+void UCustomGravityComponent::UpdateGravity()
+{
 	// Stop if UpdatedComponent is invalid
 
 	if (UpdatedComponent == NULL)
@@ -52,16 +145,7 @@ void UCustomGravityComponent::TickComponent(float DeltaTime, ELevelTick TickType
 
 	if (GravityType == EGravityType::EGT_Default)
 	{
-		if (UpdatedComponent->IsGravityEnabled() && GravityScale == 0)
-		{
-			UpdatedComponent->SetEnableGravity(false);
-			UpdatedComponent->SetAllPhysicsLinearVelocity(FVector::ZeroVector);
-		}
-		else if (!UpdatedComponent->IsGravityEnabled() && GravityScale != 0)
-		{
-			UpdatedComponent->SetEnableGravity(true);
-		}
-		CurrentGravityInfo = FGravityInfo(-UpdatedComponent->GetPhysicsVolume()->GetGravityZ(), -FVector::UpVector, EForceMode::EFM_Acceleration, true);
+		UpdateDefaultGravity();
 		return;
 	}
 
@@ -72,44 +156,232 @@ void UCustomGravityComponent::TickComponent(float DeltaTime, ELevelTick TickType
 
 	else if (GravityType == EGravityType::EGT_GlobalGravity)
 	{
-		CurrentGravityInfo = UCustomGravityManager::GetGlobalCustomGravityInfo();
+		if (!GravityManager.IsValid()) { return; }
+
+		// Read again and force computed again only when the global gravity changed
+		const FGlobalGravitySnapshot& GlobalGravity = GravityManager->GetGlobalGravitySnapshot();
+		if (GlobalGravityVersion != GlobalGravity.Version)
+		{
+			CurrentGravityInfo = GlobalGravity.GravityInfo;
+			GlobalGravityForce = GlobalGravity.GravityForce * GravityScale;
+			GlobalGravityVersion = GlobalGravity.Version;
+		}
+
+		ApplyGravity(GlobalGravityForce, CurrentGravityInfo);
+		return;
 	}
 
 	else if (GravityType == EGravityType::EGT_Point)
 	{
-		if (PlanetActor == NULL) { return; }
+		const FVector Location = UpdatedComponent->GetComponentLocation();
+		APlanetActor* CurrentPlanet = ResolvePlanet(Location);
 
-		CurrentGravityInfo = PlanetActor->GetGravityinfo(UpdatedComponent->GetComponentLocation());
-	}
+		if (CurrentPlanet == NULL) { return; }
 
+		CurrentGravityInfo = CurrentPlanet->GetGravityinfo(Location);
 
-	// Disable gravity if enabled
-	if (UpdatedComponent->IsGravityEnabled())
-	{
-		UpdatedComponent->SetEnableGravity(false);
+		if (bApplyGravityInSubsteps)
+		{
+			QueueSubstepGravity(CurrentPlanet);
+			return;
+		}
 	}
 
 
 	// Calculate Gravity Force
 	const FVector CurrentGravityDirection = CurrentGravityInfo.GravityDirection;
-	const bool bUseAccelerationChange = (CurrentGravityInfo.ForceMode == EForceMode::EFM_Acceleration);
-	const bool bShouldUseStepping = CurrentGravityInfo.bForceSubStepping;
 	const float CurrentGravityPower = CurrentGravityInfo.GravityPower * GravityScale;
 
 	const FVector GravityForce = CurrentGravityDirection.GetSafeNormal() * CurrentGravityPower;
 
 	// Apply Gravity Force
-	UpdatedComponent->BodyInstance.AddForce(GravityForce, bShouldUseStepping, bUseAccelerationChange);
+	ApplyGravity(GravityForce, CurrentGravityInfo);
+}
+
+
+APlanetActor* UCustomGravityComponent::ResolvePlanet(const FVector& Location)
+{
+	if (PlanetActor != nullptr)
+	{
+		return PlanetActor;
+	}
+
+	if (!GravityManager.IsValid())
+	{
+		return nullptr;
+	}
+
+	AutoSelectedPlanet = GravityManager->GetPlanetRegistry().FindDominantPlanet(Location, AutoSelectedPlanet.Get(), PlanetSelectionHysteresis);
+	return AutoSelectedPlanet.Get();
+}
+
+
+void UCustomGravityComponent::UpdateDefaultGravity()
+{
+	if (UpdatedComponent->IsGravityEnabled() && GravityScale == 0)
+	{
+		UpdatedComponent->SetEnableGravity(false);
+		UpdatedComponent->SetAllPhysicsLinearVelocity(FVector::ZeroVector);
+	}
+	else if (!UpdatedComponent->IsGravityEnabled() && GravityScale != 0)
+	{
+		UpdatedComponent->SetEnableGravity(true);
+	}
+	CurrentGravityInfo = FGravityInfo(-UpdatedComponent->GetPhysicsVolume()->GetGravityZ(), -FVector::UpVector, EForceMode::EFM_Acceleration, true);
+}
+
+
+void UCustomGravityComponent::ApplyGravity(const FVector& GravityForce, const FGravityInfo& GravityInfo)
+{
+	if (bSkipGravityWhileSleeping)
+	{
+		const bool bForceUnchanged = bHasLastGravityForce && GravityForce.Equals(LastGravityForce);
+		if (bForceUnchanged && !UpdatedComponent->RigidBodyIsAwake())
+		{
+			INC_DWORD_STAT(STAT_NumSleepingGravityBodies);
+			return;
+		}
+
+		LastGravityForce = GravityForce;
+		bHasLastGravityForce = true;
+
+		// AddForce would reset the sleep timer every frame : the body could never fall asleep
+		if (bForceUnchanged)
+		{
+			QueueRestingGravity(GravityForce, GravityInfo);
+			return;
+		}
+	}
+
+	INC_DWORD_STAT(STAT_NumActiveGravityBodies);
+	ApplyGravityForce(UpdatedComponent, GravityForce, GravityInfo);
+}
+
+
+void UCustomGravityComponent::QueueSubstepGravity(APlanetActor* Planet)
+{
+	FBodyInstance* BodyInstance = UpdatedComponent->GetBodyInstance();
+	if (BodyInstance == nullptr || !BodyInstance->IsInstanceSimulatingPhysics())
+	{
+		return;
+	}
+
+	if (UpdatedComponent->IsGravityEnabled())
+	{
+		UpdatedComponent->SetEnableGravity(false);
+	}
+
+	INC_DWORD_STAT(STAT_NumActiveGravityBodies);
+
+	// Custom physics callbacks are cleared after every physics step
+	SubstepGravity.Capture(Planet, GravityScale);
+	BodyInstance->AddCustomPhysics(OnCalculateSubstepGravity);
+}
+
+
+void UCustomGravityComponent::CalculateSubstepGravity(float DeltaTime, FBodyInstance* BodyInstance)
+{
+	SubstepGravity.Apply(BodyInstance);
+}
+
+
+void UCustomGravityComponent::QueueRestingGravity(const FVector& GravityForce, const FGravityInfo& GravityInfo)
+{
+	FBodyInstance* BodyInstance = UpdatedComponent->GetBodyInstance();
+	if (BodyInstance == nullptr || !BodyInstance->IsInstanceSimulatingPhysics())
+	{
+		return;
+	}
+
+	if (UpdatedComponent->IsGravityEnabled())
+	{
+		UpdatedComponent->SetEnableGravity(false);
+	}
+
+	// Runs in every substep if the scene is substepped, right away otherwise
+	RestingGravityForce = GravityForce;
+	bRestingGravityAccelChange = (GravityInfo.ForceMode == EForceMode::EFM_Acceleration);
+	BodyInstance->AddCustomPhysics(OnApplyRestingGravity);
+}
+
+
+void UCustomGravityComponent::ApplyRestingGravity(float DeltaTime, FBodyInstance* BodyInstance)
+{
+#if WITH_PHYSX
+	FPhysicsCommand::ExecuteWrite(BodyInstance->ActorHandle, [this](const FPhysicsActorHandle& Actor)
+	{
+		physx::PxRigidDynamic* PRigidDynamic = FPhysicsInterface::GetPxRigidDynamic_AssumesLocked(Actor);
+		if (PRigidDynamic == nullptr)
+		{
+			return;
+		}
+
+		// Same test as the PhysX sleep check : mass normalized kinetic energy against the sleep threshold
+		const float KineticEnergy = 0.5f * PRigidDynamic->getLinearVelocity().magnitudeSquared();
+		const bool bIsResting = KineticEnergy < PRigidDynamic->getSleepThreshold();
+
+		if (bIsResting)
+		{
+			INC_DWORD_STAT(STAT_NumRestingGravityBodies);
+		}
+		else
+		{
+			INC_DWORD_STAT(STAT_NumActiveGravityBodies);
+		}
+
+		PRigidDynamic->addForce(U2PVector(RestingGravityForce), bRestingGravityAccelChange ? physx::PxForceMode::eACCELERATION : physx::PxForceMode::eFORCE, !bIsResting);
+	});
+#endif // WITH_PHYSX
+}
+
+
+void UCustomGravityComponent::WakeUpdatedComponent()
+{
+	bHasLastGravityForce = false;
+
+	if (UpdatedComponent != nullptr && UpdatedComponent->IsSimulatingPhysics())
+	{
+		UpdatedComponent->WakeRigidBody();
+	}
+}
+
+
+void UCustomGravityComponent::ApplyGravityForce(UPrimitiveComponent* Body, const FVector& GravityForce, const FGravityInfo& GravityInfo)
+{
+	// Disable gravity if enabled
+	if (Body->IsGravityEnabled())
+	{
+		Body->SetEnableGravity(false);
+	}
+
+	const bool bUseAccelerationChange = (GravityInfo.ForceMode == EForceMode::EFM_Acceleration);
+	const bool bShouldUseStepping = GravityInfo.bForceSubStepping;
+
+	Body->BodyInstance.AddForce(GravityForce, bShouldUseStepping, bUseAccelerationChange);
 }
 
 void UCustomGravityComponent::SetGravityScale(float NewGravityScale)
 {
 	GravityScale = NewGravityScale;
+	GlobalGravityVersion = 0;
+	WakeUpdatedComponent();
+
+	if (GravityManager.IsValid())
+	{
+		GravityManager->RefreshGravityComponent(this);
+	}
 }
 
 void UCustomGravityComponent::SetGravityType(EGravityType::Type NewGravityType)
 {
 	GravityType = NewGravityType;
+	GlobalGravityVersion = 0;
+	WakeUpdatedComponent();
+
+	if (GravityManager.IsValid())
+	{
+		GravityManager->RefreshGravityComponent(this);
+	}
 }
 
 
@@ -118,9 +390,21 @@ void UCustomGravityComponent::SetUpdatedComponent(UPrimitiveComponent* NewUpdate
 	if (NewUpdatedComponent)
 	{
 		UpdatedComponent = NewUpdatedComponent;
+		bHasLastGravityForce = false;
+
+		if (GravityManager.IsValid())
+		{
+			GravityManager->RefreshGravityComponent(this);
+		}
 	}
 }
 
+void UCustomGravityComponent::SetSkipGravityWhileSleeping(bool bNewSkipGravityWhileSleeping)
+{
+	bSkipGravityWhileSleeping = bNewSkipGravityWhileSleeping;
+	bHasLastGravityForce = false;
+}
+
 void UCustomGravityComponent::SetCurrentPlanet(class APlanetActor* NewPlanet)
 {
 	PlanetActor = NewPlanet;
@@ -144,7 +428,7 @@ UPrimitiveComponent* UCustomGravityComponent::GetUpdatedComponent() const
 
 APlanetActor* UCustomGravityComponent::GetCurrentPlanet() const
 {
-	return PlanetActor;
+	return PlanetActor != nullptr ? PlanetActor : AutoSelectedPlanet.Get();
 }
 
 FVector UCustomGravityComponent::GetCurrentGravityDirection() const
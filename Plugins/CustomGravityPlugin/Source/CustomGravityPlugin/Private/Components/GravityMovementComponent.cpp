@@ -1,6 +1,20 @@
 
 #include "CustomGravityPluginPrivatePCH.h"
 
+static TAutoConsoleVariable<int32> CVarBatchedMovementUpdate(
+	TEXT("CustomGravity.BatchedMovementUpdate"),
+	0,
+	TEXT("0 : every Gravity Movement component orients its capsule and applies its gravity in its own tick (default).\n")
+	TEXT("1 : orientation and gravity are computed in parallel for all the Gravity Movement components by the world gravity manager.\n")
+	TEXT("Read when a component is initialized."),
+	ECVF_Default);
+
+/** At the EGS_Low significance tier, the ground is probed once every this many frames. */
+static const uint32 LowSignificanceGroundProbeFrames = 4;
+
+/** Floor contacts are ignored while the capsule moves away from the floor faster than this (cm/s). */
+static const float SeparatingFloorContactSpeed = 10.0f;
+
 UGravityMovementComponent::UGravityMovementComponent()
 {
 	// Initialization
@@ -10,12 +24,23 @@ UGravityMovementComponent::UGravityMovementComponent()
 	GravityScale = 2.0f;
 	bCanJump = true;
 	JumpHeight = 300.0f;
+	JumpPredictionTimeStep = 0.05f;
+	JumpPredictionMaxSteps = 60;
+	JumpPredictionSweepStride = 4;
 	JumpDistance = 300.0f;
 	GroundHitToleranceDistance = 20.0f;
 	SpeedBoostMultiplier = 2.0f;
 	AirControlRatio = 0.5f;
 	GravitySwitchDelay = 0.5f;
 	bResetVelocityOnGravitySwitch = false;
+	OrientationAngleTolerance = 0.1f;
+	bUseFixedTimeStep = false;
+	FixedTimeStep = 1.0f / 30.0f;
+	MaxFixedStepsPerFrame = 4;
+	bUseAsyncGroundQueries = false;
+	bSyncGroundQueriesForLocalPlayer = true;
+	bUseContactGroundCache = false;
+	ContactGroundCacheTime = 0.1f;
 
 	StandingVerticalOrientation = EVerticalOrientation::EVO_GravityDirection;
 	FallingVerticalOrientation = EVerticalOrientation::EVO_GravityDirection;
@@ -26,25 +51,35 @@ UGravityMovementComponent::UGravityMovementComponent()
 	CustomGravityType = EGravityType::EGT_Default;
 	CustomGravityInfo = FGravityInfo();
 	PlanetActor = nullptr;
+	PlanetSelectionHysteresis = 0.1f;
+	bApplyGravityInSubsteps = false;
 
 	SurfaceBasedGravityInfo = FGravityInfo();
 	TraceShape = ETraceShape::ETS_Sphere;
 	TraceChannel = ECollisionChannel::ECC_Visibility;
 	TraceShapeScale = 0.75f;
 	bUseCapsuleHit = false;
+	bUseGroundProbeForSurface = false;
+	bGroundProbeMultiHit = false;
 
 	bEnablePhysicsInteraction = false;
 	HitForceFactor = 0.25f;
+	MinHitImpulse = 10.0f;
 	bEnablePhysicsInteraction = true;
 	bAllowDownwardForce = false;
 
 	bDebugIsEnabled = false;
+	bFixedTimeStepActive = false;
+	FixedStepMeshRelativeLocation = FVector::ZeroVector;
+	FixedStepMeshRelativeQuat = FQuat::Identity;
 
 	// Floating Pawn Movement
 
 	MaxSpeed = 500.0;
 	Acceleration = 2048.0f;
 	Deceleration = 2048.0f;
+
+	OnCalculateSubstepGravity.BindUObject(this, &UGravityMovementComponent::CalculateSubstepGravity);
 }
 
 // Initializes the component
@@ -56,22 +91,82 @@ void UGravityMovementComponent::InitializeComponent()
 
 	CapsuleComponent = Cast<UCapsuleComponent>(UpdatedComponent);
 
+	ResetMovementState();
+
+	bUseMovementBatch = false;
+	Significance = EGravitySignificance::EGS_High;
+
+	GravityManager = AGravityWorldManager::Get(this);
+
+	if (GravityManager.IsValid() && CVarBatchedMovementUpdate.GetValueOnGameThread() != 0)
+	{
+		GravityManager->RegisterMovementComponent(this);
+	}
+
+	// Same settings as Kismet traces : complex collision, owner ignored, physical material returned
+	GroundQueryParams = FCollisionQueryParams(SCENE_QUERY_STAT(GravityMovementGroundQuery), true, GetOwner());
+	GroundQueryParams.bReturnPhysicalMaterial = true;
+}
+
+
+void UGravityMovementComponent::ResetMovementState()
+{
+	if (CapsuleComponent == NULL) { return; }
+
 	CurrentGravityInfo = FGravityInfo();
 	CurrentGravityInfo.GravityDirection = -CapsuleComponent->GetUpVector();
 	CurrentOrientationInfo = FOrientationInfo();
-	CurrentCapsuleRotation = UpdatedComponent->GetComponentRotation();
+	CurrentCapsuleQuat = CapsuleComponent->GetComponentQuat();
 	CurrentTraceShapeScale = TraceShapeScale;
 
 	TimeInAir = 0.0f;
 	bIsInAir = true;
+	bIsJumping = false;
 	bCanResetGravity = false;
 	LastWalkSpeed = MaxSpeed;
+	FloorContactTime = -1.0f;
+	JumpFrame = 0;
+	BatchedGravityPlanet = nullptr;
+	PendingHitImpulses.Reset();
+	bPendingLandingVelocityCorrection = false;
+
+	// Results of queries started from the previous location are dropped
+	GroundQueryHandle = FTraceHandle();
+	SurfaceQueryHandle = FTraceHandle();
+	GroundProbeHits.Reset();
+	CurrentStandingSurface.Init();
+	CurrentTracedSurface.Init();
+
+	if (bFixedTimeStepActive)
+	{
+		RestoreFixedStepMesh();
+	}
+
+	FixedStepAccumulator = 0.0f;
+	PreviousFixedStepQuat = CurrentCapsuleQuat;
+	FixedStepGravityForce = FVector::ZeroVector;
+	bHasFixedStepGravity = false;
+	bFixedTimeStepActive = false;
 }
 
 
+void UGravityMovementComponent::UninitializeComponent()
+{
+	if (GravityManager.IsValid())
+	{
+		GravityManager->UnregisterMovementComponent(this);
+	}
+
+	PendingHitImpulses.Empty();
+
+	Super::UninitializeComponent();
+}
+
 // Called every frame
 void UGravityMovementComponent::TickComponent(float DeltaTime, enum ELevelTick TickType, FActorComponentTickFunction *ThisTickFunction)
 {
+	SCOPE_CUSTOM_GRAVITY_TICK_TIMER();
+
 	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
 
 	// Stop if CapsuleComponet is invalid
@@ -80,6 +175,100 @@ void UGravityMovementComponent::TickComponent(float DeltaTime, enum ELevelTick T
 		return;
 	}
 
+	// Responses to the hits raised by the last physics simulation
+	FlushHitResponses();
+
+	if (bUseFixedTimeStep)
+	{
+		TickFixedTimeStep(DeltaTime);
+	}
+	else
+	{
+		if (bFixedTimeStepActive)
+		{
+			// Back to variable steps : the capsule already holds the simulated rotation
+			RestoreFixedStepMesh();
+			bFixedTimeStepActive = false;
+		}
+
+		SimulateMovement(DeltaTime);
+	}
+}
+
+
+void UGravityMovementComponent::TickFixedTimeStep(float DeltaTime)
+{
+	if (!bFixedTimeStepActive)
+	{
+		bFixedTimeStepActive = true;
+		FixedStepAccumulator = 0.0f;
+		CurrentCapsuleQuat = CapsuleComponent->GetComponentQuat();
+		PreviousFixedStepQuat = CurrentCapsuleQuat;
+		bHasFixedStepGravity = false;
+
+		USkeletalMeshComponent* PawnMesh = PawnOwner != nullptr ? PawnOwner->GetMesh() : nullptr;
+		if (PawnMesh != nullptr)
+		{
+			FixedStepMeshRelativeLocation = PawnMesh->RelativeLocation;
+			FixedStepMeshRelativeQuat = PawnMesh->RelativeRotation.Quaternion();
+		}
+	}
+
+	const float StepTime = FMath::Max(FixedTimeStep, 0.001f);
+	FixedStepAccumulator += DeltaTime;
+
+	int32 NumSteps = 0;
+	while (FixedStepAccumulator >= StepTime && NumSteps < MaxFixedStepsPerFrame)
+	{
+		PreviousFixedStepQuat = CurrentCapsuleQuat;
+		SimulateMovement(StepTime);
+		FixedStepAccumulator -= StepTime;
+		++NumSteps;
+	}
+
+	// Drop the time that could not be simulated instead of catching up over the next frames
+	FixedStepAccumulator = FMath::Min(FixedStepAccumulator, StepTime);
+
+	// The capsule keeps the simulated rotation for physics and traces : only the mesh shows the interpolated one
+	const FQuat RenderedRotation = FQuat::Slerp(PreviousFixedStepQuat, CurrentCapsuleQuat, FixedStepAccumulator / StepTime);
+	WriteFixedStepMeshRotation(CurrentCapsuleQuat.Inverse() * RenderedRotation);
+
+	// Forces are rates integrated by the physics step : the force of the last step is applied once per frame
+	if (bHasFixedStepGravity)
+	{
+		ApplyCurrentGravity(FixedStepGravityForce);
+	}
+}
+
+
+void UGravityMovementComponent::WriteFixedStepMeshRotation(const FQuat& RotationOffset)
+{
+	USkeletalMeshComponent* PawnMesh = PawnOwner != nullptr ? PawnOwner->GetMesh() : nullptr;
+	if (PawnMesh == nullptr)
+	{
+		return;
+	}
+
+	const FQuat NewRelativeQuat = RotationOffset * FixedStepMeshRelativeQuat;
+	if (NewRelativeQuat.Equals(PawnMesh->RelativeRotation.Quaternion(), KINDA_SMALL_NUMBER))
+	{
+		return;
+	}
+
+	PawnMesh->SetRelativeLocationAndRotation(RotationOffset.RotateVector(FixedStepMeshRelativeLocation), NewRelativeQuat);
+}
+
+
+void UGravityMovementComponent::RestoreFixedStepMesh()
+{
+	WriteFixedStepMeshRotation(FQuat::Identity);
+}
+
+
+void UGravityMovementComponent::SimulateMovement(float DeltaTime)
+{
+	bHasFixedStepGravity = false;
+
 	// Update CurrentTraceShapeScale
 	if (CurrentTraceShapeScale != TraceShapeScale)
 	{
@@ -88,24 +277,99 @@ void UGravityMovementComponent::TickComponent(float DeltaTime, enum ELevelTick T
 
 	/* Local Variables */
 	const EDrawDebugTrace::Type DrawDebugType = bDebugIsEnabled ? DebugDrawType.GetValue() : EDrawDebugTrace::None;
-	const ECollisionChannel CollisionChannel = CapsuleComponent->GetCollisionObjectType();
 	const FVector TraceStart = CapsuleComponent->GetComponentLocation();
+	const FVector CapsuleUpVector = CapsuleComponent->GetUpVector();
 	const float CapsuleHalfHeight = CapsuleComponent->GetScaledCapsuleHalfHeight();
 	float ShapeRadius = CapsuleComponent->GetScaledCapsuleRadius() * 0.99f;
-	FVector TraceEnd = TraceStart - CapsuleComponent->GetUpVector()* (CapsuleHalfHeight - ShapeRadius + GroundHitToleranceDistance + 1.0f);
-	FHitResult HitResult;
-	TArray<AActor*> ActorsToIgnore;
+	FVector TraceEnd = TraceStart - CapsuleUpVector * (CapsuleHalfHeight - ShapeRadius + GroundHitToleranceDistance + 1.0f);
+	UWorld* World = GetWorld();
+
+	const bool bUseAsyncQueries = ShouldUseAsyncGroundQueries();
+	if (!bUseAsyncQueries)
+	{
+		// Results of queries issued before switching to synchronous traces are dropped
+		GroundQueryHandle = FTraceHandle();
+		SurfaceQueryHandle = FTraceHandle();
+	}
 
 
 #pragma region Standing/Falling Definition
 
 	/** Testing if the Capsule is in air or standing on a walkable surface*/
 
-	UKismetSystemLibrary::SphereTraceSingle(this, TraceStart, TraceEnd, ShapeRadius,
-		UEngineTypes::ConvertToTraceType(TraceChannel), true, ActorsToIgnore, DrawDebugType, HitResult, true);
-	bIsInAir = !HitResult.bBlockingHit;
+	const FCollisionShape GroundShape = FCollisionShape::MakeSphere(ShapeRadius);
+	const bool bUseFloorContact = CanUseContactGroundCache();
+	bool bSkippedGroundProbe = false;
+
+	if (bUseFloorContact)
+	{
+		CurrentStandingSurface = FloorContactHit;
+
+		// A result issued before the contacts started is outdated
+		GroundQueryHandle = FTraceHandle();
+
+		INC_DWORD_STAT(STAT_NumCachedGroundContacts);
+		++GCustomGravityCachedGroundContacts;
+	}
+	else if (bUseAsyncQueries)
+	{
+		// Keep the last known state until the first result comes back
+		ConsumeAsyncGroundQuery(GroundQueryHandle, CurrentStandingSurface, bGroundProbeMultiHit ? &GroundProbeHits : nullptr);
+
+		GroundQueryHandle = World->AsyncSweepByChannel(bGroundProbeMultiHit ? EAsyncTraceType::Multi : EAsyncTraceType::Single,
+			TraceStart, TraceEnd, TraceChannel, GroundShape, GroundQueryParams);
+	}
+	else if (bGroundProbeMultiHit)
+	{
+		// Multi sweeps end at the first blocking hit
+		if (World->SweepMultiByChannel(GroundProbeHits, TraceStart, TraceEnd, FQuat::Identity, TraceChannel, GroundShape, GroundQueryParams))
+		{
+			CurrentStandingSurface = GroundProbeHits.Last();
+		}
+		else
+		{
+			CurrentStandingSurface.Init();
+		}
+	}
+	else if (Significance != EGravitySignificance::EGS_High)
+	{
+		// Reduced significance : line probe down to the capsule bottom, not every frame at the lowest tier
+		bSkippedGroundProbe = (Significance == EGravitySignificance::EGS_Low) && ((GFrameCounter + GetUniqueID()) % LowSignificanceGroundProbeFrames) != 0;
+		if (!bSkippedGroundProbe)
+		{
+			const FVector LineEnd = TraceStart - CapsuleUpVector * (CapsuleHalfHeight + GroundHitToleranceDistance + 1.0f);
+			World->LineTraceSingleByChannel(CurrentStandingSurface, TraceStart, LineEnd, TraceChannel, GroundQueryParams);
+		}
+		else
+		{
+			INC_DWORD_STAT(STAT_NumSignificanceGroundProbesSkipped);
+		}
+	}
+	else
+	{
+		World->SweepSingleByChannel(CurrentStandingSurface, TraceStart, TraceEnd, FQuat::Identity, TraceChannel, GroundShape, GroundQueryParams);
+	}
+
+	if (!bGroundProbeMultiHit && GroundProbeHits.Num() > 0)
+	{
+		GroundProbeHits.Reset();
+	}
+
+	if (!bUseFloorContact && !bSkippedGroundProbe)
+	{
+		INC_DWORD_STAT(STAT_NumGroundSweeps);
+		++GCustomGravityGroundSweeps;
+	}
+
+#if ENABLE_DRAW_DEBUG
+	if (DrawDebugType != EDrawDebugTrace::None && !bUseAsyncQueries && !bUseFloorContact && Significance == EGravitySignificance::EGS_High)
+	{
+		DrawGroundQuery(TraceStart, TraceEnd, GroundShape, FQuat::Identity, CurrentStandingSurface, DrawDebugType);
+	}
+#endif
+
+	bIsInAir = !CurrentStandingSurface.bBlockingHit;
 	TimeInAir = bIsInAir ? TimeInAir + DeltaTime : 0.0f;
-	CurrentStandingSurface = HitResult;
 
 #pragma endregion
 
@@ -124,7 +388,7 @@ void UGravityMovementComponent::TickComponent(float DeltaTime, enum ELevelTick T
 	{
 		CapsuleComponent->SetLinearDamping(0.5f);
 	}
-	else if (TimeInAir > 1.0f && PlanetActor != nullptr && !bIsJumping)
+	else if (TimeInAir > 1.0f && GetCurrentPlanet() != nullptr && !bIsJumping)
 	{
 		CapsuleComponent->SetLinearDamping(0.5f);
 	}
@@ -162,30 +426,57 @@ void UGravityMovementComponent::TickComponent(float DeltaTime, enum ELevelTick T
 			}
 		}
 
+		else if (bUseGroundProbeForSurface)
+		{
+			// The standing/falling sweep already hit the surface
+			CurrentTracedSurface = CurrentStandingSurface;
+		}
+
 		else
 		{
 			ShapeRadius = CapsuleComponent->GetScaledCapsuleRadius() * CurrentTraceShapeScale;
-			TraceEnd = TraceStart - CapsuleComponent->GetUpVector()* (CapsuleHalfHeight + GroundHitToleranceDistance + 1.0f);
+			TraceEnd = TraceStart - CapsuleUpVector * (CapsuleHalfHeight + GroundHitToleranceDistance + 1.0f);
 
-			if (TraceShape == ETraceShape::ETS_Line)
+			FCollisionShape SurfaceShape;
+			FQuat SurfaceShapeRotation = FQuat::Identity;
+			if (TraceShape == ETraceShape::ETS_Sphere)
 			{
-				UKismetSystemLibrary::LineTraceSingle(this, TraceStart, TraceEnd,
-					UEngineTypes::ConvertToTraceType(TraceChannel), true, ActorsToIgnore, DrawDebugType, HitResult, true);
+				TraceEnd += CapsuleUpVector * ShapeRadius;
+				SurfaceShape.SetSphere(ShapeRadius);
 			}
-			else if (TraceShape == ETraceShape::ETS_Sphere)
+			else if (TraceShape == ETraceShape::ETS_Box)
 			{
-				TraceEnd += CapsuleComponent->GetUpVector() * ShapeRadius;
-				UKismetSystemLibrary::SphereTraceSingle(this, TraceStart, TraceEnd, ShapeRadius, UEngineTypes::ConvertToTraceType(TraceChannel)
-					, true, ActorsToIgnore, DrawDebugType, HitResult, true);
+				TraceEnd += CapsuleUpVector * ShapeRadius;
+				SurfaceShape.SetBox(FVector(ShapeRadius));
+				SurfaceShapeRotation = CapsuleComponent->GetComponentQuat();
 			}
-			else
+
+			if (bUseAsyncQueries && TraceShape != ETraceShape::ETS_Box)
 			{
-				TraceEnd += CapsuleComponent->GetUpVector() * ShapeRadius;
-				UKismetSystemLibrary::BoxTraceSingle(this, TraceStart, TraceEnd, FVector(1, 1, 1)*ShapeRadius, CapsuleComponent->GetComponentRotation(),
-					UEngineTypes::ConvertToTraceType(TraceChannel), true, ActorsToIgnore, DrawDebugType, HitResult, true);
+				ConsumeAsyncGroundQuery(SurfaceQueryHandle, CurrentTracedSurface);
+
+				SurfaceQueryHandle = (TraceShape == ETraceShape::ETS_Line)
+					? World->AsyncLineTraceByChannel(EAsyncTraceType::Single, TraceStart, TraceEnd, TraceChannel, GroundQueryParams)
+					: World->AsyncSweepByChannel(EAsyncTraceType::Single, TraceStart, TraceEnd, TraceChannel, SurfaceShape, GroundQueryParams);
 			}
+			else
+			{
+				if (TraceShape == ETraceShape::ETS_Line)
+				{
+					World->LineTraceSingleByChannel(CurrentTracedSurface, TraceStart, TraceEnd, TraceChannel, GroundQueryParams);
+				}
+				else
+				{
+					World->SweepSingleByChannel(CurrentTracedSurface, TraceStart, TraceEnd, SurfaceShapeRotation, TraceChannel, SurfaceShape, GroundQueryParams);
+				}
 
-			CurrentTracedSurface = HitResult;
+#if ENABLE_DRAW_DEBUG
+				if (DrawDebugType != EDrawDebugTrace::None)
+				{
+					DrawGroundQuery(TraceStart, TraceEnd, SurfaceShape, SurfaceShapeRotation, CurrentTracedSurface, DrawDebugType);
+				}
+#endif
+			}
 
 		}
 		const bool bOnWalkableSurface = CurrentTracedSurface.IsValidBlockingHit();
@@ -193,8 +484,9 @@ void UGravityMovementComponent::TickComponent(float DeltaTime, enum ELevelTick T
 
 		if (bOnWalkableSurface)
 		{
-			SurfaceBasedGravityInfo.GravityDirection = -HitResult.ImpactNormal;
+			SurfaceBasedGravityInfo.GravityDirection = -CurrentTracedSurface.ImpactNormal;
 			CurrentGravityInfo = SurfaceBasedGravityInfo;
+			PointGravityPlanet.Reset();
 			CurrentOrientationInfo = OrientationSettings.SurfaceBasedGravity;
 		}
 
@@ -230,8 +522,15 @@ void UGravityMovementComponent::TickComponent(float DeltaTime, enum ELevelTick T
 
 				CurrentGravityInfo = FGravityInfo(-CapsuleComponent->GetWorld()->GetGravityZ(), -FVector::UpVector, EForceMode::EFM_Acceleration, true);
 				CurrentOrientationInfo = OrientationSettings.DefaultGravity;
+				PointGravityPlanet.Reset();
 
-				UpdateCapsuleRotation(DeltaTime, -CurrentGravityInfo.GravityDirection, CurrentOrientationInfo.BaseRotationInterpSpeed);
+				if (ShouldUseMovementBatch())
+				{
+					GravityManager->QueueMovementUpdate(this, DeltaTime, GetOrientationInterpSpeed(CurrentOrientationInfo.BaseRotationInterpSpeed), nullptr, false);
+					return;
+				}
+
+				UpdateCapsuleRotation(DeltaTime, -CurrentGravityInfo.GravityDirection, GetOrientationInterpSpeed(CurrentOrientationInfo.BaseRotationInterpSpeed));
 
 				return;
 			}
@@ -241,24 +540,41 @@ void UGravityMovementComponent::TickComponent(float DeltaTime, enum ELevelTick T
 			{
 				CurrentGravityInfo = CustomGravityInfo;
 				CurrentOrientationInfo = OrientationSettings.CustomGravity;
+				PointGravityPlanet.Reset();
 				break;
 			}
 
 
 			case EGravityType::EGT_GlobalGravity:
 			{
-				CurrentGravityInfo = UCustomGravityManager::GetGlobalCustomGravityInfo();
+				if (!GravityManager.IsValid()) { return; }
+				CurrentGravityInfo = GravityManager->GetGlobalGravitySnapshot().GravityInfo;
 				CurrentOrientationInfo = OrientationSettings.GlobalCustomGravity;
+				PointGravityPlanet.Reset();
 				break;
 			}
 
 
 			case EGravityType::EGT_Point:
 			{
-				if (PlanetActor == NULL) { return; }
-				CurrentPlanetDistance = FVector::Distance(CapsuleComponent->GetOwner()->GetActorLocation(), PlanetActor->GetActorLocation());
-				CurrentGravityInfo = PlanetActor->GetGravityinfo(CapsuleComponent->GetComponentLocation());
+				APlanetActor* CurrentPlanet = ResolvePlanet(CapsuleComponent->GetComponentLocation());
+				if (CurrentPlanet == NULL)
+				{
+					PointGravityPlanet.Reset();
+					return;
+				}
+				CurrentPlanetDistance = FVector::Distance(CapsuleComponent->GetOwner()->GetActorLocation(), CurrentPlanet->GetActorLocation());
+				if (ShouldUseMovementBatch())
+				{
+					// Evaluated by the movement batch
+					BatchedGravityPlanet = CurrentPlanet;
+				}
+				else
+				{
+					CurrentGravityInfo = CurrentPlanet->GetGravityinfo(CapsuleComponent->GetComponentLocation());
+				}
 				CurrentOrientationInfo = OrientationSettings.PointGravity;
+				PointGravityPlanet = CurrentPlanet;
 				break;
 			}
 			}
@@ -270,14 +586,6 @@ void UGravityMovementComponent::TickComponent(float DeltaTime, enum ELevelTick T
 
 
 	/** Variables definition & initialization */
-	const FVector CurrentGravityDirection = CurrentGravityInfo.GravityDirection;
-	const bool bUseAccelerationChange = (CurrentGravityInfo.ForceMode == EForceMode::EFM_Acceleration);
-	const bool bShouldUseStepping = CurrentGravityInfo.bForceSubStepping;
-	const float CurrentGravityPower = CurrentGravityInfo.GravityPower * GravityScale;
-
-	const FVector GravityForce = CurrentGravityDirection.GetSafeNormal() * CurrentGravityPower;
-
-
 	float InterpSpeed = CurrentOrientationInfo.BaseRotationInterpSpeed;
 	if (bIsInAir)
 	{
@@ -292,48 +600,232 @@ void UGravityMovementComponent::TickComponent(float DeltaTime, enum ELevelTick T
 	{
 		InterpSpeed = CurrentOrientationInfo.BaseRotationInterpSpeed;
 	}
+	InterpSpeed = GetOrientationInterpSpeed(InterpSpeed);
 
 	/************************************/
 	/****************************************/
 
+	if (ShouldUseMovementBatch())
+	{
+		GravityManager->QueueMovementUpdate(this, DeltaTime, InterpSpeed, BatchedGravityPlanet, true);
+		BatchedGravityPlanet = nullptr;
+		return;
+	}
+
 	/* Update Rotation : Orient Capsule's up vector to have the same direction as -gravityDirection */
-	UpdateCapsuleRotation(DeltaTime, -CurrentGravityDirection, InterpSpeed);
+	UpdateCapsuleRotation(DeltaTime, -CurrentGravityInfo.GravityDirection, InterpSpeed);
 
 	/* Apply Gravity*/
-	ApplyGravity(GravityForce, bShouldUseStepping, bUseAccelerationChange);
+	if (bUseFixedTimeStep)
+	{
+		FixedStepGravityForce = CalcGravityForce(CurrentGravityInfo, GravityScale);
+		bHasFixedStepGravity = true;
+	}
+	else
+	{
+		ApplyCurrentGravity(CalcGravityForce(CurrentGravityInfo, GravityScale));
+	}
+}
+
+
+#if ENABLE_DRAW_DEBUG
+void UGravityMovementComponent::DrawGroundQuery(const FVector& Start, const FVector& End, const FCollisionShape& Shape, const FQuat& Rotation, const FHitResult& Hit, EDrawDebugTrace::Type DrawDebugType) const
+{
+	UWorld* World = GetWorld();
+	const bool bPersistent = (DrawDebugType == EDrawDebugTrace::Persistent);
+	const float LifeTime = (DrawDebugType == EDrawDebugTrace::ForDuration) ? 5.0f : 0.0f;
+	const FColor TraceColor = Hit.bBlockingHit ? FColor::Green : FColor::Red;
+	const FVector ShapeLocation = Hit.bBlockingHit ? Hit.Location : End;
+
+	DrawDebugLine(World, Start, ShapeLocation, TraceColor, bPersistent, LifeTime);
+
+	if (Shape.IsSphere())
+	{
+		DrawDebugSphere(World, ShapeLocation, Shape.GetSphereRadius(), 12, TraceColor, bPersistent, LifeTime);
+	}
+	else if (Shape.IsBox())
+	{
+		DrawDebugBox(World, ShapeLocation, Shape.GetExtent(), Rotation, TraceColor, bPersistent, LifeTime);
+	}
+
+	if (Hit.bBlockingHit)
+	{
+		DrawDebugPoint(World, Hit.ImpactPoint, 16.0f, FColor::Red, bPersistent, LifeTime);
+	}
+}
+#endif // ENABLE_DRAW_DEBUG
+
+
+bool UGravityMovementComponent::CanUseContactGroundCache() const
+{
+	if (!bUseContactGroundCache || bGroundProbeMultiHit || bIsJumping || FloorContactTime < 0.0f)
+	{
+		return false;
+	}
+
+	return GetWorld()->GetTimeSeconds() - FloorContactTime <= ContactGroundCacheTime;
+}
+
+
+bool UGravityMovementComponent::ShouldUseAsyncGroundQueries() const
+{
+	if (!bUseAsyncGroundQueries)
+	{
+		return false;
+	}
+
+	if (bSyncGroundQueriesForLocalPlayer)
+	{
+		const APawn* Pawn = GetPawnOwner();
+		return Pawn == nullptr || !Pawn->IsLocallyControlled();
+	}
+
+	return true;
+}
+
+
+bool UGravityMovementComponent::ConsumeAsyncGroundQuery(FTraceHandle& Handle, FHitResult& OutHit, TArray<FHitResult>* OutHits) const
+{
+	FTraceDatum TraceDatum;
+	if (!Handle.IsValid() || !GetWorld()->QueryTraceData(Handle, TraceDatum))
+	{
+		return false;
+	}
+
+	Handle = FTraceHandle();
+
+	OutHit = FHitResult();
+	for (const FHitResult& Hit : TraceDatum.OutHits)
+	{
+		if (Hit.bBlockingHit)
+		{
+			OutHit = Hit;
+			break;
+		}
+	}
+
+	if (OutHits != nullptr)
+	{
+		*OutHits = MoveTemp(TraceDatum.OutHits);
+	}
+
+	return true;
+}
+void UGravityMovementComponent::CalculateSubstepGravity(float DeltaTime, FBodyInstance* BodyInstance)
+{
+	SubstepGravity.Apply(BodyInstance);
 }
 
 
 
 void UGravityMovementComponent::UpdateCapsuleRotation(float DeltaTime, const FVector& TargetUpVector, float RotationSpeed)
 {
-	const FVector CapsuleUp = CapsuleComponent->GetUpVector();
-	const FQuat DeltaQuat = FQuat::FindBetween(CapsuleUp, TargetUpVector);
-	const FQuat TargetQuat = DeltaQuat * CapsuleComponent->GetComponentRotation().Quaternion();
+	// Written at every fixed step too : the next step traces from the rotation it simulated
+	FQuat NewRotation;
+	const bool bRotationChanged = CalcCapsuleRotation(CapsuleComponent->GetComponentQuat(), CurrentCapsuleQuat, TargetUpVector,
+		DeltaTime, RotationSpeed, OrientationSettings.InterpolationMode, GetAlignedAngleCos(), NewRotation);
+
+	WriteCapsuleRotation(bRotationChanged, NewRotation);
+	CurrentCapsuleQuat = CapsuleComponent->GetComponentQuat();
+}
 
 
-	switch (OrientationSettings.InterpolationMode)
+void UGravityMovementComponent::WriteCapsuleRotation(bool bRotationChanged, const FQuat& NewRotation)
+{
+	// Aligned capsules are not moved : no transform propagation to the attached components
+	if (bRotationChanged)
 	{
-	case EOrientationInterpolationMode::OIM_RInterpTo:
+		CapsuleComponent->SetWorldRotation(NewRotation);
+		INC_DWORD_STAT(STAT_NumCapsuleRotationUpdates);
+		++GCustomGravityCapsuleRotationUpdates;
+	}
+	else
 	{
-		CapsuleComponent->SetWorldRotation(
-			FMath::RInterpTo(CurrentCapsuleRotation, TargetQuat.Rotator(), DeltaTime, RotationSpeed));
-		break;
+		INC_DWORD_STAT(STAT_NumCapsuleRotationUpdatesAvoided);
+		++GCustomGravityCapsuleRotationUpdatesAvoided;
 	}
-	case EOrientationInterpolationMode::OIM_Slerp:
+}
+
+
+float UGravityMovementComponent::GetAlignedAngleCos() const
+{
+	return FMath::Cos(FMath::DegreesToRadians(OrientationAngleTolerance));
+}
+
+
+bool UGravityMovementComponent::CalcCapsuleRotation(const FQuat& CapsuleRotation, const FQuat& InterpStartRotation, const FVector& TargetUpVector,
+	float DeltaTime, float RotationSpeed, EOrientationInterpolationMode::Type InterpolationMode, float AlignedAngleCos, FQuat& OutRotation)
+{
+	const FVector CapsuleUp = CapsuleRotation.GetAxisZ();
+	if (FVector::DotProduct(CapsuleUp, TargetUpVector.GetSafeNormal()) >= AlignedAngleCos)
 	{
-		CapsuleComponent->SetWorldRotation(
-			FQuat::Slerp(CurrentCapsuleRotation.Quaternion(), TargetQuat, DeltaTime* RotationSpeed));
-		break;
+		OutRotation = CapsuleRotation;
+		return false;
 	}
-	default:
+
+	const FQuat DeltaQuat = FQuat::FindBetween(CapsuleUp, TargetUpVector);
+	const FQuat TargetQuat = DeltaQuat * CapsuleRotation;
+
+	// Per mode at any speed : RInterpTo snaps at speed 0, Slerp keeps the start rotation
+	switch (InterpolationMode)
 	{
-		CapsuleComponent->SetWorldRotation(TargetQuat);
+	case EOrientationInterpolationMode::OIM_RInterpTo:
+		OutRotation = FMath::RInterpTo(InterpStartRotation.Rotator(), TargetQuat.Rotator(), DeltaTime, RotationSpeed).Quaternion();
+		break;
+
+	case EOrientationInterpolationMode::OIM_Slerp:
+		OutRotation = FQuat::Slerp(InterpStartRotation, TargetQuat, DeltaTime * RotationSpeed);
+		break;
+
+	default:
+		OutRotation = TargetQuat;
 		break;
 	}
+
+	return true;
+}
+
+
+FVector UGravityMovementComponent::CalcGravityForce(const FGravityInfo& GravityInfo, float GravityScale)
+{
+	return GravityInfo.GravityDirection.GetSafeNormal() * GravityInfo.GravityPower * GravityScale;
+}
+
+
+void UGravityMovementComponent::ApplyCurrentGravity(const FVector& GravityForce)
+{
+	if (bApplyGravityInSubsteps && PointGravityPlanet.IsValid())
+	{
+		// Custom physics callbacks are cleared after every physics step
+		SubstepGravity.Capture(PointGravityPlanet.Get(), GravityScale);
+		CapsuleComponent->GetBodyInstance()->AddCustomPhysics(OnCalculateSubstepGravity);
+	}
+	else
+	{
+		ApplyGravity(GravityForce, CurrentGravityInfo.bForceSubStepping, CurrentGravityInfo.ForceMode == EForceMode::EFM_Acceleration);
+	}
+}
+
+
+void UGravityMovementComponent::ApplyMovementBatchResult(bool bRotationChanged, const FQuat& NewRotation, const FGravityInfo* EvaluatedGravityInfo, const FVector& GravityForce, bool bApplyGravity)
+{
+	if (CapsuleComponent == nullptr)
+	{
+		return;
 	}
 
-	CurrentCapsuleRotation = CapsuleComponent->GetComponentRotation();
+	if (EvaluatedGravityInfo != nullptr)
+	{
+		CurrentGravityInfo = *EvaluatedGravityInfo;
+	}
+
+	WriteCapsuleRotation(bRotationChanged, NewRotation);
+	CurrentCapsuleQuat = CapsuleComponent->GetComponentQuat();
+
+	if (bApplyGravity)
+	{
+		ApplyCurrentGravity(GravityForce);
+	}
 }
 
 
@@ -347,11 +839,15 @@ void UGravityMovementComponent::DoJump(FVector ForwardsDir)
 {
 	if (bIsInAir) { return; }
 
-	const float TargetJumpHeight = JumpHeight + CapsuleComponent->GetScaledCapsuleHalfHeight();
-	const FVector JumpImpulse = (CapsuleComponent->GetUpVector() * FMath::Sqrt(TargetJumpHeight * 2.f * GetGravityPower()));// +(ForwardsDir * JumpDistance);
+	const FVector JumpImpulse = GetJumpImpulse();// +(ForwardsDir * JumpDistance);
 	const bool bUseAccl = (CurrentGravityInfo.ForceMode == EForceMode::EFM_Acceleration);
 
 	CapsuleComponent->GetBodyInstance()->AddImpulse(JumpImpulse, bUseAccl);
+
+	// The ground is swept again until the next floor contact
+	bIsJumping = true;
+	FloorContactTime = -1.0f;
+	JumpFrame = GFrameCounter;
 }
 
 void UGravityMovementComponent::AddExternalForce(FVector ExternalForce)
@@ -395,22 +891,19 @@ void UGravityMovementComponent::CapsuleHited(class UPrimitiveComponent* MyComp,
 
 	CapsuleHitResult = Hit;
 
-	const float FallingSpeed = FMath::Abs(GetFallingSpeed());
-
-	if (FallingSpeed > 100.0f)
-	{
-		FVector CurrentVelocity = CapsuleComponent->GetComponentVelocity();
-		CurrentVelocity = CapsuleComponent->GetComponentTransform().InverseTransformVector(CurrentVelocity);
-		CurrentVelocity.Z = 0.0f;
-		CurrentVelocity = CapsuleComponent->GetComponentTransform().TransformVector(CurrentVelocity);
-		CapsuleComponent->SetPhysicsLinearVelocity(CurrentVelocity);
-	}
+	INC_DWORD_STAT(STAT_NumCapsuleHits);
 
 	const float OnGroundHitDot = FVector::DotProduct(HitNormal, CapsuleComponent->GetUpVector());
 
-	if (OnGroundHitDot > 0.75f)
+	// The floor is still touched during the physics step applying the jump impulse : that contact does not land the pawn
+	const bool bIsJumpStep = bIsJumping && GFrameCounter == JumpFrame;
+	const bool bIsLeavingFloor = FVector::DotProduct(CapsuleComponent->GetPhysicsLinearVelocity(), CapsuleComponent->GetUpVector()) > SeparatingFloorContactSpeed;
+
+	if (OnGroundHitDot > 0.75f && !bIsJumpStep && !bIsLeavingFloor)
 	{
 		bIsJumping = false;
+		FloorContactHit = Hit;
+		FloorContactTime = GetWorld()->GetTimeSeconds();
 		StandingOnActor = Other;
 		if (StandingOnActor && StandingOnActor->IsA(APlanetActor::StaticClass()))
 		{
@@ -422,6 +915,19 @@ void UGravityMovementComponent::CapsuleHited(class UPrimitiveComponent* MyComp,
 		}
 	}
 
+	// Contact noise. Sweep hits of the movement (UFloatingPawnMovement) have no impulse : only physics contacts are filtered
+	if (!NormalImpulse.IsNearlyZero() && NormalImpulse.SizeSquared() < FMath::Square(MinHitImpulse))
+	{
+		INC_DWORD_STAT(STAT_NumFilteredCapsuleHits);
+		return;
+	}
+
+	// Responses are applied once per frame by FlushHitResponses, whatever the number of contacts
+	if (FMath::Abs(GetFallingSpeed()) > 100.0f)
+	{
+		bPendingLandingVelocityCorrection = true;
+	}
+
 	if (!bEnablePhysicsInteraction)
 	{
 		return;
@@ -429,6 +935,11 @@ void UGravityMovementComponent::CapsuleHited(class UPrimitiveComponent* MyComp,
 
 	if (OtherComp != NULL && OtherComp->IsAnySimulatingPhysics())
 	{
+		if (OnGroundHitDot > 0.99f && !bAllowDownwardForce)
+		{
+			return;
+		}
+
 		const FVector OtherLoc = OtherComp->GetComponentLocation();
 		const FVector Loc = CapsuleComponent->GetComponentLocation();
 		FVector ImpulseDir = (OtherLoc - Loc).GetSafeNormal();
@@ -448,15 +959,50 @@ void UGravityMovementComponent::CapsuleHited(class UPrimitiveComponent* MyComp,
 		float ImpulseStrength = GetMovementVelocity().Size() * TouchForceFactorModified;
 
 		FVector Impulse = ImpulseDir * ImpulseStrength;
-		float dot = FVector::DotProduct(HitNormal, CapsuleComponent->GetUpVector());
 
-		if (dot > 0.99f && !bAllowDownwardForce)
+		FPendingHitImpulse* PendingImpulse = PendingHitImpulses.FindByPredicate([OtherComp](const FPendingHitImpulse& Pending) { return Pending.Component == OtherComp; });
+		if (PendingImpulse == nullptr)
 		{
-			return;
+			PendingImpulse = &PendingHitImpulses[PendingHitImpulses.AddUninitialized()];
+			PendingImpulse->Component = OtherComp;
+			PendingImpulse->Impulse = FVector::ZeroVector;
+			PendingImpulse->Location = FVector::ZeroVector;
+			PendingImpulse->NumContacts = 0;
 		}
 
-		OtherComp->AddImpulseAtLocation(Impulse, HitLocation);
+		PendingImpulse->Impulse += Impulse;
+		PendingImpulse->Location += HitLocation;
+		PendingImpulse->NumContacts++;
+	}
+}
+
+
+void UGravityMovementComponent::FlushHitResponses()
+{
+	if (bPendingLandingVelocityCorrection)
+	{
+		bPendingLandingVelocityCorrection = false;
+
+		FVector CurrentVelocity = CapsuleComponent->GetComponentVelocity();
+		CurrentVelocity = CapsuleComponent->GetComponentTransform().InverseTransformVector(CurrentVelocity);
+		CurrentVelocity.Z = 0.0f;
+		CurrentVelocity = CapsuleComponent->GetComponentTransform().TransformVector(CurrentVelocity);
+		CapsuleComponent->SetPhysicsLinearVelocity(CurrentVelocity);
 	}
+
+	// Contacts with the same body are the same push : the averaged impulse is applied once
+	for (const FPendingHitImpulse& PendingImpulse : PendingHitImpulses)
+	{
+		UPrimitiveComponent* OtherComp = PendingImpulse.Component.Get();
+		if (OtherComp != nullptr && OtherComp->IsAnySimulatingPhysics())
+		{
+			const float ContactScale = 1.0f / PendingImpulse.NumContacts;
+			OtherComp->AddImpulseAtLocation(PendingImpulse.Impulse * ContactScale, PendingImpulse.Location * ContactScale);
+			INC_DWORD_STAT(STAT_NumHitImpulsesApplied);
+		}
+	}
+
+	PendingHitImpulses.Reset();
 }
 
 
@@ -506,6 +1052,87 @@ float UGravityMovementComponent::GetInAirTime() const
 	return TimeInAir;
 }
 
+float UGravityMovementComponent::GetOrientationInterpSpeed(float InterpSpeed) const
+{
+	return (Significance == EGravitySignificance::EGS_High) ? InterpSpeed : 0.0f;
+}
+
+FVector UGravityMovementComponent::GetJumpImpulse() const
+{
+	const float TargetJumpHeight = JumpHeight + CapsuleComponent->GetScaledCapsuleHalfHeight();
+	return CapsuleComponent->GetUpVector() * FMath::Sqrt(TargetJumpHeight * 2.f * GetGravityPower());
+}
+
+FVector UGravityMovementComponent::GetJumpLaunchVelocity() const
+{
+	if (CapsuleComponent == nullptr) { return FVector::ZeroVector; }
+
+	const bool bUseAccl = (CurrentGravityInfo.ForceMode == EForceMode::EFM_Acceleration);
+	const FVector JumpImpulse = GetJumpImpulse();
+	return CapsuleComponent->GetPhysicsLinearVelocity() + (bUseAccl ? JumpImpulse : JumpImpulse / CapsuleComponent->GetMass());
+}
+
+void UGravityMovementComponent::SetupTrajectorySolver(FGravityTrajectorySolver& Solver) const
+{
+	Solver.TimeStep = JumpPredictionTimeStep;
+	Solver.MaxSteps = FMath::Max(JumpPredictionMaxSteps, 1);
+	Solver.SweepStride = JumpPredictionSweepStride;
+	Solver.TraceChannel = TraceChannel;
+	Solver.QueryParams = GroundQueryParams;
+	Solver.Shape = FCollisionShape::MakeCapsule(CapsuleComponent->GetScaledCapsuleRadius() * 0.99f, CapsuleComponent->GetScaledCapsuleHalfHeight() * 0.99f);
+
+	const float MassScale = (CurrentGravityInfo.ForceMode == EForceMode::EFM_Force) ? 1.0f / CapsuleComponent->GetMass() : 1.0f;
+
+	// Point gravity is evaluated along the path, other gravities are constant over a jump.
+	// PointGravityPlanet is only the attracting planet while point gravity is in use (not overridden by the surface normal)
+	if (CustomGravityType == EGravityType::EGT_Point && PointGravityPlanet.IsValid())
+	{
+		Solver.Planet = PointGravityPlanet.Get();
+		Solver.PlanetAccelerationScale = GravityScale * (PointGravityPlanet->ForceMode == EForceMode::EFM_Force ? 1.0f / CapsuleComponent->GetMass() : 1.0f);
+	}
+	else if (CustomGravityType == EGravityType::EGT_Default)
+	{
+		Solver.Planet = nullptr;
+		Solver.ConstantAcceleration = (GravityScale != 0) ? FVector(0.0f, 0.0f, GetWorld()->GetGravityZ()) : FVector::ZeroVector;
+	}
+	else
+	{
+		Solver.Planet = nullptr;
+		Solver.ConstantAcceleration = CalcGravityForce(CurrentGravityInfo, GravityScale) * MassScale;
+	}
+}
+
+bool UGravityMovementComponent::PredictJump(FGravityJumpPrediction& OutPrediction) const
+{
+	return PredictTrajectory(GetJumpLaunchVelocity(), OutPrediction);
+}
+
+bool UGravityMovementComponent::PredictTrajectory(const FVector& LaunchVelocity, FGravityJumpPrediction& OutPrediction) const
+{
+	if (CapsuleComponent == nullptr || GetWorld() == nullptr)
+	{
+		OutPrediction = FGravityJumpPrediction();
+		return false;
+	}
+
+	FGravityTrajectorySolver Solver;
+	SetupTrajectorySolver(Solver);
+	return Solver.Predict(GetWorld(), CapsuleComponent->GetComponentLocation(), LaunchVelocity, OutPrediction);
+}
+
+void UGravityMovementComponent::PredictTrajectories(const TArray<FVector>& LaunchVelocities, TArray<FGravityJumpPrediction>& OutPredictions) const
+{
+	if (CapsuleComponent == nullptr || GetWorld() == nullptr)
+	{
+		OutPredictions.Reset();
+		return;
+	}
+
+	FGravityTrajectorySolver Solver;
+	SetupTrajectorySolver(Solver);
+	Solver.PredictBatch(GetWorld(), CapsuleComponent->GetComponentLocation(), LaunchVelocities, OutPredictions);
+}
+
 void UGravityMovementComponent::EnableDebuging()
 {
 	bDebugIsEnabled = true;
@@ -540,7 +1167,23 @@ void UGravityMovementComponent::ClearPlanet()
 
 APlanetActor* UGravityMovementComponent::GetCurrentPlanet() const
 {
-	return PlanetActor;
+	return PlanetActor != nullptr ? PlanetActor : AutoSelectedPlanet.Get();
+}
+
+APlanetActor* UGravityMovementComponent::ResolvePlanet(const FVector& Location)
+{
+	if (PlanetActor != nullptr)
+	{
+		return PlanetActor;
+	}
+
+	if (!GravityManager.IsValid())
+	{
+		return nullptr;
+	}
+
+	AutoSelectedPlanet = GravityManager->GetPlanetRegistry().FindDominantPlanet(Location, AutoSelectedPlanet.Get(), PlanetSelectionHysteresis);
+	return AutoSelectedPlanet.Get();
 }
 
 bool UGravityMovementComponent::IsSprinting() const
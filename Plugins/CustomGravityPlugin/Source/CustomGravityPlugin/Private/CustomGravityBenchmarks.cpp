@@ -0,0 +1,417 @@
+// Copyright 2015 Elhoussine Mehnik (Mhousse1247). All Rights Reserved.
+//******************* http://ue4resources.com/ *********************//
+
+
+#include "CustomGravityPluginPrivatePCH.h"
+#include "CustomGravityBenchmarks.h"
+
+/**
+* Scaling benchmark, shared by the CustomGravity.ScalingBenchmark console command and the CustomGravity.Performance.Scaling test.
+* Results are written to the log (LogCustomGravity) and to Saved/Profiling/CustomGravity.
+*/
+
+namespace CustomGravityBenchmarks
+{
+	/** Time stamp written by a tick function, used to time the physics step. */
+	struct FTimeStampTickFunction : public FTickFunction
+	{
+		double TimeStamp = 0.0;
+
+		virtual void ExecuteTick(float DeltaTime, ELevelTick TickType, ENamedThreads::Type CurrentThread, const FGraphEventRef& MyCompletionGraphEvent) override
+		{
+			TimeStamp = FPlatformTime::Seconds();
+		}
+
+		virtual FString DiagnosticMessage() override
+		{
+			return TEXT("CustomGravity.ScalingBenchmark physics timer");
+		}
+	};
+
+	/**
+	* Times one physics tick function of the world, and only that one :
+	* a time stamp is taken right before it (as its prerequisite) and right after it (depending on it).
+	* For the end physics tick function this includes waiting for the simulation and fetching its results,
+	* but not the TG_DuringPhysics ticks that run while physics simulates.
+	*/
+	struct FPhysicsTickTimer
+	{
+		FTimeStampTickFunction Before;
+		FTimeStampTickFunction After;
+
+		void Register(UWorld* World, FTickFunction& PhysicsTickFunction, ETickingGroup TickGroup)
+		{
+			Before.TickGroup = TickGroup;
+			Before.RegisterTickFunction(World->PersistentLevel);
+			PhysicsTickFunction.AddPrerequisite(World, Before);
+
+			After.TickGroup = TickGroup;
+			After.AddPrerequisite(World, PhysicsTickFunction);
+			After.RegisterTickFunction(World->PersistentLevel);
+		}
+
+		/** PhysicsTickFunction is null if the world is already gone. */
+		void Unregister(UWorld* World, FTickFunction* PhysicsTickFunction)
+		{
+			if (PhysicsTickFunction != nullptr)
+			{
+				PhysicsTickFunction->RemovePrerequisite(World, Before);
+			}
+			Before.UnRegisterTickFunction();
+			After.UnRegisterTickFunction();
+		}
+
+		double GetSeconds() const
+		{
+			return FMath::Max(0.0, After.TimeStamp - Before.TimeStamp);
+		}
+	};
+
+	/**
+	* Spawns N ACustomPhysicsActor and N AGravityPawn for each gravity type and each N,
+	* and records the frame, physics and plugin tick times of a fixed number of frames per scenario.
+	*/
+	class FScalingBenchmark : public FTickableGameObject
+	{
+	public:
+
+		FScalingBenchmark(UWorld* InWorld, const TArray<int32>& InBodyCounts, int32 InNumFrames, bool bInQuitWhenDone)
+			: World(InWorld)
+			, BodyCounts(InBodyCounts)
+			, NumFrames(InNumFrames)
+			, bQuitWhenDone(bInQuitWhenDone)
+			, ScenarioIndex(0)
+			, Frame(0)
+			, LastFrameTime(0.0)
+			, bIsRunning(true)
+		{
+			BodyMesh = LoadObject<UStaticMesh>(nullptr, TEXT("/Engine/BasicShapes/Sphere.Sphere"));
+
+			// One planet for Point Gravity, under the spawn grid
+			FTransform PlanetTransform(FVector(0.0f, 0.0f, -PlanetRadius - 500.0f));
+			Planet = World->SpawnActorDeferred<APlanetActor>(APlanetActor::StaticClass(), PlanetTransform);
+			Planet->CollisionType = ECollisionType::ECol_Sphere;
+			Planet->SphereCollisionRaduis = PlanetRadius;
+			Planet->SphereOfInfluenceRadius = PlanetRadius * 4.0f;
+			Planet->FinishSpawning(PlanetTransform);
+
+			StartPhysicsTimer.Register(World.Get(), World->StartPhysicsTickFunction, TG_StartPhysics);
+			EndPhysicsTimer.Register(World.Get(), World->EndPhysicsTickFunction, TG_EndPhysics);
+
+			CsvLines.Add(TEXT("Bodies,GravityType,Frame,FrameMs,PhysicsMs,PluginTickMs,CapsuleRotationUpdates,CapsuleRotationUpdatesAvoided,SignificanceTicksSaved"));
+
+			SpawnScenario();
+		}
+
+		// FTickableGameObject interface
+		virtual bool IsTickable() const override { return bIsRunning; }
+		virtual UWorld* GetTickableGameObjectWorld() const override { return World.Get(); }
+		virtual TStatId GetStatId() const override { RETURN_QUICK_DECLARE_CYCLE_STAT(FScalingBenchmark, STATGROUP_Tickables); }
+
+		virtual void Tick(float DeltaTime) override
+		{
+			if (!World.IsValid())
+			{
+				UE_LOG(LogCustomGravity, Warning, TEXT("Scaling benchmark aborted : world destroyed."));
+				Stop();
+				return;
+			}
+
+			// Tickable objects tick after the world : one call per frame
+			const double Now = FPlatformTime::Seconds();
+			const double FrameTime = Now - LastFrameTime;
+			LastFrameTime = Now;
+
+			// Standing pawns should not rotate their capsule once aligned with their gravity
+			const uint64 RotationUpdates = GCustomGravityCapsuleRotationUpdates - LastRotationUpdates;
+			const uint64 RotationUpdatesAvoided = GCustomGravityCapsuleRotationUpdatesAvoided - LastRotationUpdatesAvoided;
+			LastRotationUpdates = GCustomGravityCapsuleRotationUpdates;
+			LastRotationUpdatesAvoided = GCustomGravityCapsuleRotationUpdatesAvoided;
+
+			// Ticks saved by the significance tiers (CustomGravity.Significance)
+			const uint64 TicksSaved = GCustomGravitySignificanceTicksSaved - LastTicksSaved;
+			LastTicksSaved = GCustomGravitySignificanceTicksSaved;
+
+			if (Frame >= WarmupFrames)
+			{
+				const double PhysicsTime = StartPhysicsTimer.GetSeconds() + EndPhysicsTimer.GetSeconds();
+
+				CsvLines.Add(FString::Printf(TEXT("%d,%s,%d,%.4f,%.4f,%.4f,%llu,%llu,%llu"),
+					GetNumBodies(),
+					*UCustomGravityManager::Conv_GravityTypeToString(GetGravityType()),
+					Frame - WarmupFrames,
+					FrameTime * 1000.0,
+					PhysicsTime * 1000.0,
+					GCustomGravityTickSeconds * 1000.0,
+					RotationUpdates,
+					RotationUpdatesAvoided,
+					TicksSaved));
+
+				TotalFrameTime += FrameTime;
+				TotalPhysicsTime += PhysicsTime;
+				TotalPluginTime += GCustomGravityTickSeconds;
+				TotalRotationUpdates += RotationUpdates;
+				TotalRotationUpdatesAvoided += RotationUpdatesAvoided;
+			}
+			else
+			{
+				TotalFrameTime = TotalPhysicsTime = TotalPluginTime = 0.0;
+				TotalRotationUpdates = TotalRotationUpdatesAvoided = 0;
+			}
+
+			GCustomGravityTickSeconds = 0.0;
+
+			if (++Frame < WarmupFrames + NumFrames)
+			{
+				return;
+			}
+
+			FScalingResult& Result = Results[Results.AddUninitialized()];
+			Result.NumBodies = GetNumBodies();
+			Result.GravityType = GetGravityType();
+			Result.FrameMs = TotalFrameTime * 1000.0 / NumFrames;
+			Result.PhysicsMs = TotalPhysicsTime * 1000.0 / NumFrames;
+			Result.PluginTickMs = TotalPluginTime * 1000.0 / NumFrames;
+			Result.CapsuleRotationUpdates = (double)TotalRotationUpdates / NumFrames;
+			Result.CapsuleRotationUpdatesAvoided = (double)TotalRotationUpdatesAvoided / NumFrames;
+
+			UE_LOG(LogCustomGravity, Log, TEXT("Scaling benchmark %6d bodies, %-14s : frame %8.3f ms | physics %8.3f ms | plugin ticks %8.3f ms | capsule rotations %.1f written, %.1f avoided per frame"),
+				Result.NumBodies, *UCustomGravityManager::Conv_GravityTypeToString(Result.GravityType),
+				Result.FrameMs, Result.PhysicsMs, Result.PluginTickMs,
+				Result.CapsuleRotationUpdates, Result.CapsuleRotationUpdatesAvoided);
+
+			DestroyScenario();
+
+			if (++ScenarioIndex < BodyCounts.Num() * NumGravityTypes)
+			{
+				SpawnScenario();
+			}
+			else
+			{
+				WriteCsv();
+				Stop();
+
+				if (bQuitWhenDone)
+				{
+					FPlatformMisc::RequestExit(false);
+				}
+			}
+		}
+		// End of FTickableGameObject interface
+
+		bool IsRunning() const { return bIsRunning; }
+
+		const TArray<FScalingResult>& GetResults() const { return Results; }
+
+		void Stop()
+		{
+			if (!bIsRunning)
+			{
+				return;
+			}
+
+			bIsRunning = false;
+			GCustomGravityTimeTicks = false;
+
+			if (World.IsValid())
+			{
+				DestroyScenario();
+
+				if (Planet.IsValid())
+				{
+					Planet->Destroy();
+				}
+			}
+
+			UWorld* const TimedWorld = World.Get();
+			StartPhysicsTimer.Unregister(TimedWorld, TimedWorld != nullptr ? &TimedWorld->StartPhysicsTickFunction : nullptr);
+			EndPhysicsTimer.Unregister(TimedWorld, TimedWorld != nullptr ? &TimedWorld->EndPhysicsTickFunction : nullptr);
+		}
+
+	private:
+
+		static const int32 NumGravityTypes = EGravityType::EGT_GlobalGravity + 1;
+		static const int32 WarmupFrames = 30;
+		static constexpr float PlanetRadius = 20000.0f;
+		static constexpr float Spacing = 150.0f;
+
+		int32 GetNumBodies() const { return BodyCounts[ScenarioIndex / NumGravityTypes]; }
+		EGravityType::Type GetGravityType() const { return (EGravityType::Type)(ScenarioIndex % NumGravityTypes); }
+
+		void SpawnScenario()
+		{
+			const int32 NumBodies = GetNumBodies();
+			const EGravityType::Type GravityType = GetGravityType();
+			const int32 GridSize = FMath::CeilToInt(FMath::Sqrt((float)NumBodies * 2));
+
+			FActorSpawnParameters SpawnInfo;
+			SpawnInfo.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+
+			for (int32 Index = 0; Index < NumBodies * 2; ++Index)
+			{
+				const FVector Location((Index % GridSize - GridSize / 2) * Spacing, (Index / GridSize - GridSize / 2) * Spacing, 500.0f);
+
+				if (Index % 2 == 0)
+				{
+					ACustomPhysicsActor* PhysicsActor = World->SpawnActor<ACustomPhysicsActor>(Location, FRotator::ZeroRotator, SpawnInfo);
+					PhysicsActor->GetMesh()->SetStaticMesh(BodyMesh);
+					PhysicsActor->GetMesh()->SetSimulatePhysics(true);
+					PhysicsActor->GetGravityComponent()->SetGravityType(GravityType);
+					SpawnedActors.Add(PhysicsActor);
+				}
+				else
+				{
+					AGravityPawn* Pawn = World->SpawnActor<AGravityPawn>(Location, FRotator::ZeroRotator, SpawnInfo);
+					Pawn->GetMovementComponent()->CustomGravityType = GravityType;
+					SpawnedActors.Add(Pawn);
+				}
+			}
+
+			Frame = 0;
+			LastFrameTime = FPlatformTime::Seconds();
+		}
+
+		void DestroyScenario()
+		{
+			for (const TWeakObjectPtr<AActor>& Actor : SpawnedActors)
+			{
+				if (Actor.IsValid())
+				{
+					Actor->Destroy();
+				}
+			}
+			SpawnedActors.Reset();
+
+			// Do not measure the next scenario with the garbage of this one
+			GEngine->ForceGarbageCollection(true);
+		}
+
+		void WriteCsv()
+		{
+			const FString FileName = FPaths::ProfilingDir() / TEXT("CustomGravity") / FString::Printf(TEXT("ScalingBenchmark-%s.csv"), *FDateTime::Now().ToString());
+
+			if (FFileHelper::SaveStringToFile(FString::Join(CsvLines, LINE_TERMINATOR), *FileName))
+			{
+				UE_LOG(LogCustomGravity, Log, TEXT("Scaling benchmark written to %s"), *FileName);
+			}
+			else
+			{
+				UE_LOG(LogCustomGravity, Error, TEXT("Scaling benchmark : could not write %s"), *FileName);
+			}
+		}
+
+		TWeakObjectPtr<UWorld> World;
+		TArray<int32> BodyCounts;
+		int32 NumFrames;
+		bool bQuitWhenDone;
+
+		int32 ScenarioIndex;
+		int32 Frame;
+		double LastFrameTime;
+		double TotalFrameTime = 0.0;
+		double TotalPhysicsTime = 0.0;
+		double TotalPluginTime = 0.0;
+		uint64 TotalRotationUpdates = 0;
+		uint64 TotalRotationUpdatesAvoided = 0;
+		uint64 LastRotationUpdates = 0;
+		uint64 LastRotationUpdatesAvoided = 0;
+		uint64 LastTicksSaved = 0;
+		bool bIsRunning;
+
+		UStaticMesh* BodyMesh;
+		TWeakObjectPtr<APlanetActor> Planet;
+		TArray<TWeakObjectPtr<AActor>> SpawnedActors;
+
+		FPhysicsTickTimer StartPhysicsTimer;
+		FPhysicsTickTimer EndPhysicsTimer;
+
+		TArray<FString> CsvLines;
+		TArray<FScalingResult> Results;
+	};
+
+	static TUniquePtr<FScalingBenchmark> ScalingBenchmark;
+
+	void StartScalingBenchmark(UWorld* World, const TArray<int32>& BodyCounts, int32 NumFrames, bool bQuitWhenDone)
+	{
+		StopScalingBenchmark();
+
+		GCustomGravityTickSeconds = 0.0;
+		GCustomGravityTimeTicks = true;
+
+		ScalingBenchmark = MakeUnique<FScalingBenchmark>(World, BodyCounts, NumFrames, bQuitWhenDone);
+	}
+
+	void StopScalingBenchmark()
+	{
+		if (ScalingBenchmark.IsValid())
+		{
+			ScalingBenchmark->Stop();
+		}
+	}
+
+	bool IsScalingBenchmarkRunning()
+	{
+		return ScalingBenchmark.IsValid() && ScalingBenchmark->IsRunning();
+	}
+
+	TArray<FScalingResult> GetScalingBenchmarkResults()
+	{
+		return ScalingBenchmark.IsValid() ? ScalingBenchmark->GetResults() : TArray<FScalingResult>();
+	}
+
+	/**
+	* The CustomGravity.Performance.Scaling test gates one body count in an empty test world.
+	* This command runs the same scenarios in the loaded map of a running game, rendering included,
+	* for any body counts, and keeps the per-frame CSV to compare builds or machines.
+	* Usage : CustomGravity.ScalingBenchmark [NumFrames] [BodyCount ...] [-quit]
+	* Headless : UE4Editor <Project> <Map> -game -nullrhi -unattended -ExecCmds="CustomGravity.ScalingBenchmark 300 -quit"
+	*/
+	void RunScalingBenchmark(const TArray<FString>& Args, UWorld* World)
+	{
+		if (World == nullptr || !World->IsGameWorld())
+		{
+			UE_LOG(LogCustomGravity, Error, TEXT("CustomGravity.ScalingBenchmark needs a game world."));
+			return;
+		}
+
+		if (IsScalingBenchmarkRunning())
+		{
+			UE_LOG(LogCustomGravity, Warning, TEXT("CustomGravity.ScalingBenchmark is already running."));
+			return;
+		}
+
+		int32 NumFrames = 300;
+		TArray<int32> BodyCounts;
+		bool bQuitWhenDone = false;
+
+		for (int32 Index = 0; Index < Args.Num(); ++Index)
+		{
+			if (Args[Index] == TEXT("-quit"))
+			{
+				bQuitWhenDone = true;
+			}
+			else if (Index == 0)
+			{
+				NumFrames = FMath::Max(1, FCString::Atoi(*Args[Index]));
+			}
+			else
+			{
+				BodyCounts.Add(FMath::Max(1, FCString::Atoi(*Args[Index])));
+			}
+		}
+
+		if (BodyCounts.Num() == 0)
+		{
+			BodyCounts = { 100, 1000, 10000 };
+		}
+
+		StartScalingBenchmark(World, BodyCounts, NumFrames, bQuitWhenDone);
+	}
+}
+
+static FAutoConsoleCommandWithWorldAndArgs ScalingBenchmarkCommand(
+	TEXT("CustomGravity.ScalingBenchmark"),
+	TEXT("Spawns N CustomPhysicsActors and N GravityPawns per gravity type, for N = 100, 1k and 10k (default),\n")
+	TEXT("and writes per-frame frame, physics and plugin tick times to Saved/Profiling/CustomGravity.\n")
+	TEXT("Usage : CustomGravity.ScalingBenchmark [NumFrames] [BodyCount ...] [-quit]"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateStatic(&CustomGravityBenchmarks::RunScalingBenchmark));
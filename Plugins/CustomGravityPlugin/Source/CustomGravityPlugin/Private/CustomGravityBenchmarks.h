@@ -0,0 +1,48 @@
+// Copyright 2015 Elhoussine Mehnik (Mhousse1247). All Rights Reserved.
+//******************* http://ue4resources.com/ *********************//
+
+#pragma once
+
+/** Benchmarks behind the CustomGravity.* console commands, shared with the plugin automation tests. */
+namespace CustomGravityBenchmarks
+{
+	/** Returns the number of seconds taken by the fastest of NumRuns calls to Func. */
+	template<typename FuncType>
+	double MeasureBestTime(int32 NumRuns, FuncType Func)
+	{
+		double BestTime = MAX_dbl;
+		for (int32 Run = 0; Run < NumRuns; ++Run)
+		{
+			const double StartTime = FPlatformTime::Seconds();
+			Func();
+			BestTime = FMath::Min(BestTime, FPlatformTime::Seconds() - StartTime);
+		}
+		return BestTime;
+	}
+
+	/** Per frame averages of one scaling benchmark scenario. */
+	struct FScalingResult
+	{
+		int32 NumBodies;
+		EGravityType::Type GravityType;
+		double FrameMs;
+		double PhysicsMs;
+		double PluginTickMs;
+		double CapsuleRotationUpdates;
+		double CapsuleRotationUpdatesAvoided;
+	};
+
+	/**
+	* Starts the scaling benchmark in World, ticked with the world.
+	* Each body count is run for every gravity type, for NumFrames frames after a warm up.
+	*/
+	void StartScalingBenchmark(UWorld* World, const TArray<int32>& BodyCounts, int32 NumFrames, bool bQuitWhenDone);
+
+	/** Stops the scaling benchmark and destroys what it spawned. */
+	void StopScalingBenchmark();
+
+	bool IsScalingBenchmarkRunning();
+
+	/** Results of the scenarios run so far by the last scaling benchmark. */
+	TArray<FScalingResult> GetScalingBenchmarkResults();
+}
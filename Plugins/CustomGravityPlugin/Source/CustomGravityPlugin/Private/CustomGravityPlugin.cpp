@@ -4,6 +4,38 @@
 
 #include "CustomGravityPluginPrivatePCH.h"
 
+DEFINE_LOG_CATEGORY(LogCustomGravity);
+
+DEFINE_STAT(STAT_GravityComponentsBatchedUpdate);
+DEFINE_STAT(STAT_GravityComponentsTick);
+DEFINE_STAT(STAT_NumBatchedGravityComponents);
+DEFINE_STAT(STAT_NumTickingGravityComponents);
+DEFINE_STAT(STAT_GravityMovementBatch);
+DEFINE_STAT(STAT_NumBatchedMovementComponents);
+DEFINE_STAT(STAT_NumSleepingGravityBodies);
+DEFINE_STAT(STAT_NumRestingGravityBodies);
+DEFINE_STAT(STAT_NumActiveGravityBodies);
+DEFINE_STAT(STAT_NumGroundSweeps);
+DEFINE_STAT(STAT_NumCachedGroundContacts);
+DEFINE_STAT(STAT_GroundSweepsSavedPercent);
+DEFINE_STAT(STAT_NumCapsuleRotationUpdates);
+DEFINE_STAT(STAT_NumCapsuleRotationUpdatesAvoided);
+DEFINE_STAT(STAT_NumCapsuleHits);
+DEFINE_STAT(STAT_NumFilteredCapsuleHits);
+DEFINE_STAT(STAT_NumHitImpulsesApplied);
+DEFINE_STAT(STAT_NumSignificanceTicksSaved);
+DEFINE_STAT(STAT_NumSignificanceGroundProbesSkipped);
+DEFINE_STAT(STAT_NumSignificanceGravityUpdatesSkipped);
+DEFINE_STAT(STAT_NumPawnTransformUpdates);
+DEFINE_STAT(STAT_NumPawnTransformUpdatesAvoided);
+
+double GCustomGravityTickSeconds = 0.0;
+bool GCustomGravityTimeTicks = false;
+uint64 GCustomGravityGroundSweeps = 0;
+uint64 GCustomGravityCachedGroundContacts = 0;
+uint64 GCustomGravityCapsuleRotationUpdates = 0;
+uint64 GCustomGravityCapsuleRotationUpdatesAvoided = 0;
+uint64 GCustomGravitySignificanceTicksSaved = 0;
 
 
 #define LOCTEXT_NAMESPACE "FCustomGravityPluginModule"
@@ -6,6 +6,7 @@
 
 //Module
 #include "CustomGravityPlugin.h"
+#include "CustomGravityStats.h"
 
 //Components
 #include "CustomGravityComponent.h"
@@ -17,9 +18,14 @@
 
 //Objects
 #include "CustomGravityManager.h"
+#include "PlanetRegistry.h"
+#include "GravityFieldAsset.h"
+#include "GravityTrajectory.h"
+#include "GravitySignificance.h"
 #include "Kismet/KismetSystemLibrary.h"
 
 //Actors
 #include "PlanetActor.h"
 #include "CustomPhysicsActor.h"
+#include "GravityWorldManager.h"
 
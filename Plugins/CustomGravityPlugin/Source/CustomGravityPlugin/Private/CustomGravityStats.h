@@ -0,0 +1,64 @@
+// Copyright 2015 Elhoussine Mehnik (Mhousse1247). All Rights Reserved.
+//******************* http://ue4resources.com/ *********************//
+
+#pragma once
+
+DECLARE_LOG_CATEGORY_EXTERN(LogCustomGravity, Log, All);
+
+/** "stat CustomGravity" */
+DECLARE_STATS_GROUP(TEXT("CustomGravity"), STATGROUP_CustomGravity, STATCAT_Advanced);
+
+/** Gravity Components : cost of the batched update compared to the per-component tick path. */
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Gravity Components Batched Update"), STAT_GravityComponentsBatchedUpdate, STATGROUP_CustomGravity, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Gravity Components Tick"), STAT_GravityComponentsTick, STATGROUP_CustomGravity, );
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Batched Gravity Components"), STAT_NumBatchedGravityComponents, STATGROUP_CustomGravity, );
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Ticking Gravity Components"), STAT_NumTickingGravityComponents, STATGROUP_CustomGravity, );
+
+/** Gravity Movement Components : batched movement pass (CustomGravity.BatchedMovementUpdate). */
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Gravity Movement Batch"), STAT_GravityMovementBatch, STATGROUP_CustomGravity, );
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Batched Movement Components"), STAT_NumBatchedMovementComponents, STATGROUP_CustomGravity, );
+
+/** Bodies using bSkipGravityWhileSleeping : sleeping bodies are left untouched, resting bodies get gravity without being kept awake. */
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Sleeping Gravity Bodies"), STAT_NumSleepingGravityBodies, STATGROUP_CustomGravity, );
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Resting Gravity Bodies"), STAT_NumRestingGravityBodies, STATGROUP_CustomGravity, );
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Active Gravity Bodies"), STAT_NumActiveGravityBodies, STATGROUP_CustomGravity, );
+
+/** Gravity Movement Components : ground sweeps compared to floor contacts reused by bUseContactGroundCache. */
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Ground Sweeps"), STAT_NumGroundSweeps, STATGROUP_CustomGravity, );
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Cached Ground Contacts"), STAT_NumCachedGroundContacts, STATGROUP_CustomGravity, );
+DECLARE_FLOAT_ACCUMULATOR_STAT_EXTERN(TEXT("Ground Sweeps Saved (%)"), STAT_GroundSweepsSavedPercent, STATGROUP_CustomGravity, );
+
+/** Totals since startup behind STAT_GroundSweepsSavedPercent, set once per frame by the gravity manager. Game thread only. */
+extern uint64 GCustomGravityGroundSweeps;
+extern uint64 GCustomGravityCachedGroundContacts;
+
+/** Gravity Movement Components : capsule rotations written, and skipped because the capsule was already aligned. */
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Capsule Rotation Updates"), STAT_NumCapsuleRotationUpdates, STATGROUP_CustomGravity, );
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Capsule Rotation Updates Avoided"), STAT_NumCapsuleRotationUpdatesAvoided, STATGROUP_CustomGravity, );
+
+/** Totals since startup of the capsule rotation stats (CustomGravity.ScalingBenchmark). Game thread only. */
+extern uint64 GCustomGravityCapsuleRotationUpdates;
+extern uint64 GCustomGravityCapsuleRotationUpdatesAvoided;
+
+/** Gravity Movement Components : capsule hits received, ignored (MinHitImpulse), and merged impulses applied to physics bodies. */
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Capsule Hits"), STAT_NumCapsuleHits, STATGROUP_CustomGravity, );
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Capsule Hits Filtered"), STAT_NumFilteredCapsuleHits, STATGROUP_CustomGravity, );
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Hit Impulses Applied"), STAT_NumHitImpulsesApplied, STATGROUP_CustomGravity, );
+
+/** Significance (CustomGravity.Significance) : pawn actor and mesh ticks, ground probes and point gravity evaluations saved by the lower tiers. */
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Significance Ticks Saved"), STAT_NumSignificanceTicksSaved, STATGROUP_CustomGravity, );
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Significance Ground Probes Skipped"), STAT_NumSignificanceGroundProbesSkipped, STATGROUP_CustomGravity, );
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Significance Gravity Updates Skipped"), STAT_NumSignificanceGravityUpdatesSkipped, STATGROUP_CustomGravity, );
+
+/** Total of STAT_NumSignificanceTicksSaved since startup (CustomGravity.ScalingBenchmark). Game thread only. */
+extern uint64 GCustomGravitySignificanceTicksSaved;
+
+/** Gravity pawns : gizmo and mesh rotation writes, and writes skipped because nothing visible changed. */
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Pawn Transform Updates"), STAT_NumPawnTransformUpdates, STATGROUP_CustomGravity, );
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Pawn Transform Updates Avoided"), STAT_NumPawnTransformUpdatesAvoided, STATGROUP_CustomGravity, );
+
+/** Plugin tick time, accumulated in seconds while GCustomGravityTimeTicks is set (CustomGravity.ScalingBenchmark). Game thread only. */
+extern double GCustomGravityTickSeconds;
+extern bool GCustomGravityTimeTicks;
+
+#define SCOPE_CUSTOM_GRAVITY_TICK_TIMER() FSimpleScopeSecondsCounter CustomGravityTickTimer(GCustomGravityTickSeconds, GCustomGravityTimeTicks)
@@ -1,53 +1,97 @@
 #include "CustomGravityPluginPrivatePCH.h"
 
-//Initialization
-FGravityInfo UCustomGravityManager::GlobalCustomGravityInfo = FGravityInfo();
-
 
 UCustomGravityManager::UCustomGravityManager()
 {
 	//
 }
 
-void UCustomGravityManager::SetGlobalCustomGravityPower(float NewGravityPower)
+void UCustomGravityManager::SetGlobalCustomGravityPower(const UObject* WorldContextObject, float NewGravityPower)
 {
-	GlobalCustomGravityInfo.GravityPower = NewGravityPower;
+	AGravityWorldManager* GravityManager = AGravityWorldManager::Get(WorldContextObject);
+	if (GravityManager != nullptr)
+	{
+		FGravityInfo GravityInfo = GravityManager->GetGlobalGravityInfo();
+		GravityInfo.GravityPower = NewGravityPower;
+		GravityManager->SetGlobalGravityInfo(GravityInfo);
+	}
 }
 
-void UCustomGravityManager::SetGlobalCustomGravityDirection(const FVector& NewGravityDirection)
+void UCustomGravityManager::SetGlobalCustomGravityDirection(const UObject* WorldContextObject, const FVector& NewGravityDirection)
 {
-	GlobalCustomGravityInfo.GravityDirection = NewGravityDirection;
+	AGravityWorldManager* GravityManager = AGravityWorldManager::Get(WorldContextObject);
+	if (GravityManager != nullptr)
+	{
+		FGravityInfo GravityInfo = GravityManager->GetGlobalGravityInfo();
+		GravityInfo.GravityDirection = NewGravityDirection;
+		GravityManager->SetGlobalGravityInfo(GravityInfo);
+	}
 }
 
-void UCustomGravityManager::SetGlobalCustomGravityForceMode(EForceMode::Type NewForceMode)
+void UCustomGravityManager::SetGlobalCustomGravityForceMode(const UObject* WorldContextObject, EForceMode::Type NewForceMode)
 {
-	GlobalCustomGravityInfo.ForceMode = NewForceMode;
+	AGravityWorldManager* GravityManager = AGravityWorldManager::Get(WorldContextObject);
+	if (GravityManager != nullptr)
+	{
+		FGravityInfo GravityInfo = GravityManager->GetGlobalGravityInfo();
+		GravityInfo.ForceMode = NewForceMode;
+		GravityManager->SetGlobalGravityInfo(GravityInfo);
+	}
 }
 
-void UCustomGravityManager::SetGlobalCustomGravityInfo(const FGravityInfo& NewGravityInfo)
+void UCustomGravityManager::SetGlobalCustomGravityInfo(const UObject* WorldContextObject, const FGravityInfo& NewGravityInfo)
 {
-	GlobalCustomGravityInfo = NewGravityInfo;
+	AGravityWorldManager* GravityManager = AGravityWorldManager::Get(WorldContextObject);
+	if (GravityManager != nullptr)
+	{
+		GravityManager->SetGlobalGravityInfo(NewGravityInfo);
+	}
 }
 
-float UCustomGravityManager::GetGlobalCustomGravityPower()
+float UCustomGravityManager::GetGlobalCustomGravityPower(const UObject* WorldContextObject)
 {
-	return GlobalCustomGravityInfo.GravityPower;
+	return GetGlobalCustomGravityInfo(WorldContextObject).GravityPower;
 }
 
-FVector UCustomGravityManager::GetGlobalCustomGravityDirection()
+FVector UCustomGravityManager::GetGlobalCustomGravityDirection(const UObject* WorldContextObject)
 {
-	return GlobalCustomGravityInfo.GravityDirection.GetSafeNormal();
+	return GetGlobalCustomGravityInfo(WorldContextObject).GravityDirection;
+}
 
+TEnumAsByte<EForceMode::Type> UCustomGravityManager::GetGlobalCustomGravityForceMode(const UObject* WorldContextObject)
+{
+	return GetGlobalCustomGravityInfo(WorldContextObject).ForceMode;
 }
 
-TEnumAsByte<EForceMode::Type> UCustomGravityManager::GetGlobalCustomGravityForceMode()
+FGravityInfo UCustomGravityManager::GetGlobalCustomGravityInfo(const UObject* WorldContextObject)
 {
-	return GlobalCustomGravityInfo.ForceMode;
+	// Worlds without gravity manager (editor worlds) use the default global gravity
+	const AGravityWorldManager* GravityManager = AGravityWorldManager::Find(WorldContextObject);
+	return GravityManager != nullptr ? GravityManager->GetGlobalGravityInfo() : FGravityInfo();
 }
 
-FGravityInfo UCustomGravityManager::GetGlobalCustomGravityInfo()
+int32 UCustomGravityManager::GetGlobalCustomGravityVersion(const UObject* WorldContextObject)
 {
-	return GlobalCustomGravityInfo;
+	const AGravityWorldManager* GravityManager = AGravityWorldManager::Find(WorldContextObject);
+	return GravityManager != nullptr ? GravityManager->GetGlobalGravityVersion() : 0;
+}
+
+void UCustomGravityManager::BindGlobalCustomGravityChanged(const UObject* WorldContextObject, const FGlobalCustomGravityChangedDelegate& Event)
+{
+	AGravityWorldManager* GravityManager = AGravityWorldManager::Get(WorldContextObject);
+	if (GravityManager != nullptr)
+	{
+		GravityManager->OnGlobalGravityChangedEvent.AddUnique(Event);
+	}
+}
+
+void UCustomGravityManager::UnbindGlobalCustomGravityChanged(const UObject* WorldContextObject, const FGlobalCustomGravityChangedDelegate& Event)
+{
+	AGravityWorldManager* GravityManager = AGravityWorldManager::Find(WorldContextObject);
+	if (GravityManager != nullptr)
+	{
+		GravityManager->OnGlobalGravityChangedEvent.Remove(Event);
+	}
 }
 
 FString UCustomGravityManager::Conv_GravityInfoToString(FGravityInfo GravityInfo)
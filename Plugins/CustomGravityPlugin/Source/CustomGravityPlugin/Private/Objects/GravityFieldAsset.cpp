@@ -0,0 +1,301 @@
+// Copyright 2015 Elhoussine Mehnik (Mhousse1247). All Rights Reserved.
+//******************* http://ue4resources.com/ *********************//
+
+
+#include "CustomGravityPluginPrivatePCH.h"
+#include "Async/AsyncFileHandle.h"
+#include "Async/Async.h"
+
+
+UGravityFieldAsset::UGravityFieldAsset(const FObjectInitializer& ObjectInitializer)
+	: Super(ObjectInitializer)
+{
+	CellSize = 50.0f;
+	MaxSurfaceDistance = 1000.0f;
+	NumBricks = 0;
+	BrickGridSize = FIntVector::ZeroValue;
+	FieldOrigin = FVector::ZeroVector;
+	BakedCellSize = CellSize;
+	InvCellSize = 1.0f / CellSize;
+	ReadFileHandle = nullptr;
+	ReadRequest = nullptr;
+
+	// Cooked bricks go to a separate bulk file and are only read by LoadField()
+	BrickData.SetBulkDataFlags(BULKDATA_Force_NOT_InlinePayload);
+}
+
+void UGravityFieldAsset::Serialize(FArchive& Ar)
+{
+	Super::Serialize(Ar);
+
+	BrickData.Serialize(Ar, this);
+}
+
+void UGravityFieldAsset::BeginDestroy()
+{
+	// The read callback writes into Samples
+	ReleaseReadRequest();
+
+	Super::BeginDestroy();
+}
+
+void UGravityFieldAsset::ReleaseReadRequest()
+{
+	if (ReadRequest != nullptr)
+	{
+		ReadRequest->WaitCompletion();
+		delete ReadRequest;
+		ReadRequest = nullptr;
+	}
+
+	if (ReadFileHandle != nullptr)
+	{
+		delete ReadFileHandle;
+		ReadFileHandle = nullptr;
+	}
+}
+
+#if WITH_EDITOR
+
+bool UGravityFieldAsset::Bake(UPrimitiveComponent* Collision, const FTransform& FieldToWorld, const FBox& LocalBounds)
+{
+	if (Collision == nullptr || !LocalBounds.IsValid)
+	{
+		return false;
+	}
+
+	BakedCellSize = FMath::Max(CellSize, 1.0f);
+	InvCellSize = 1.0f / BakedCellSize;
+
+	const float BrickSize = BakedCellSize * BrickCells;
+	const FVector FieldSize = LocalBounds.GetSize() + FVector(2.0f * MaxSurfaceDistance);
+
+	FieldOrigin = LocalBounds.Min - FVector(MaxSurfaceDistance);
+	BrickGridSize = FIntVector(
+		FMath::Max(FMath::CeilToInt(FieldSize.X / BrickSize), 1),
+		FMath::Max(FMath::CeilToInt(FieldSize.Y / BrickSize), 1),
+		FMath::Max(FMath::CeilToInt(FieldSize.Z / BrickSize), 1));
+
+	BrickIndices.Init(INDEX_NONE, BrickGridSize.X * BrickGridSize.Y * BrickGridSize.Z);
+	NumBricks = 0;
+
+	TArray<int8> NewSamples;
+	TArray<FVector> BrickDirections;
+	BrickDirections.SetNumUninitialized(SamplesPerBrick);
+
+	for (int32 BrickZ = 0; BrickZ < BrickGridSize.Z; ++BrickZ)
+	{
+		for (int32 BrickY = 0; BrickY < BrickGridSize.Y; ++BrickY)
+		{
+			for (int32 BrickX = 0; BrickX < BrickGridSize.X; ++BrickX)
+			{
+				bool bIsNearSurface = false;
+
+				for (int32 SampleIndex = 0; SampleIndex < SamplesPerBrick; ++SampleIndex)
+				{
+					const FIntVector Cell(
+						BrickX * BrickCells + SampleIndex % BrickSamples,
+						BrickY * BrickCells + (SampleIndex / BrickSamples) % BrickSamples,
+						BrickZ * BrickCells + SampleIndex / (BrickSamples * BrickSamples));
+
+					const FVector LocalLocation = FieldOrigin + FVector(Cell.X, Cell.Y, Cell.Z) * BakedCellSize;
+					const FVector WorldLocation = FieldToWorld.TransformPosition(LocalLocation);
+
+					FVector ClosestPoint;
+					const float Distance = Collision->GetClosestPointOnCollision(WorldLocation, ClosestPoint);
+
+					if (Distance < 0.0f)
+					{
+						UE_LOG(LogCustomGravity, Error, TEXT("%s : can not bake the gravity field, %s has no simple collision."), *GetName(), *Collision->GetName());
+						return false;
+					}
+
+					if (Distance > 0.0f)
+					{
+						BrickDirections[SampleIndex] = FieldToWorld.InverseTransformVectorNoScale(ClosestPoint - WorldLocation).GetSafeNormal();
+						bIsNearSurface |= (Distance <= MaxSurfaceDistance);
+					}
+					else
+					{
+						// Inside the collision : attract to the planet center
+						BrickDirections[SampleIndex] = (-LocalLocation).GetSafeNormal();
+					}
+				}
+
+				if (!bIsNearSurface)
+				{
+					continue;
+				}
+
+				BrickIndices[(BrickZ * BrickGridSize.Y + BrickY) * BrickGridSize.X + BrickX] = NumBricks++;
+
+				for (const FVector& Direction : BrickDirections)
+				{
+					NewSamples.Add((int8)FMath::RoundToInt(Direction.X * 127.0f));
+					NewSamples.Add((int8)FMath::RoundToInt(Direction.Y * 127.0f));
+					NewSamples.Add((int8)FMath::RoundToInt(Direction.Z * 127.0f));
+				}
+			}
+		}
+	}
+
+	BrickData.Lock(LOCK_READ_WRITE);
+	FMemory::Memcpy(BrickData.Realloc(NewSamples.Num()), NewSamples.GetData(), NewSamples.Num());
+	BrickData.Unlock();
+
+	ReleaseReadRequest();
+	bIsFieldLoaded = false;
+	Samples = MoveTemp(NewSamples);
+	bIsFieldLoaded = true;
+
+	MarkPackageDirty();
+
+	UE_LOG(LogCustomGravity, Log, TEXT("%s : baked %d / %d bricks (%.1f KB)."), *GetName(), NumBricks, BrickIndices.Num(), Samples.Num() / 1024.0f);
+	return true;
+}
+
+#endif // WITH_EDITOR
+
+void UGravityFieldAsset::LoadField()
+{
+	// Read complete : free the request on the game thread
+	if (ReadRequest != nullptr)
+	{
+		if (!ReadRequest->PollCompletion())
+		{
+			return;
+		}
+		ReleaseReadRequest();
+	}
+
+	if (IsFieldLoaded())
+	{
+		return;
+	}
+
+	const int32 BulkDataSize = BrickData.GetBulkDataSize();
+	if (BulkDataSize == 0)
+	{
+		return;
+	}
+
+	InvCellSize = 1.0f / FMath::Max(BakedCellSize, 1.0f);
+	Samples.SetNumUninitialized(BulkDataSize);
+
+	FString Filename = BrickData.GetFilename();
+	if ((BrickData.GetBulkDataFlags() & BULKDATA_PayloadInSeperateFile) != 0)
+	{
+		Filename = FPaths::ChangeExtension(Filename, TEXT(".ubulk"));
+	}
+
+	// Already in memory (just baked) or not readable as raw bytes : nothing to gain from an async read
+	if (BrickData.IsBulkDataLoaded() || BrickData.IsStoredCompressedOnDisk() || Filename.IsEmpty())
+	{
+		void* Dest = Samples.GetData();
+
+		// The editor keeps the bulk data so the asset can be saved again
+		BrickData.GetCopy(&Dest, !GIsEditor);
+		bIsFieldLoaded = true;
+		return;
+	}
+
+	ReadFileHandle = FPlatformFileManager::Get().GetPlatformFile().OpenAsyncRead(*Filename);
+	if (ReadFileHandle == nullptr)
+	{
+		UE_LOG(LogCustomGravity, Warning, TEXT("%s : can not open %s, bodies use point gravity."), *GetName(), *Filename);
+		return;
+	}
+
+	// Runs on an IO thread : Samples is only published through bIsFieldLoaded
+	ReadCallback = [this, BulkDataSize](bool bWasCancelled, IAsyncReadRequest* Request)
+	{
+		uint8* Data = Request->GetReadResults();
+		if (Data != nullptr)
+		{
+			if (!bWasCancelled)
+			{
+				FMemory::Memcpy(Samples.GetData(), Data, BulkDataSize);
+				bIsFieldLoaded = true;
+			}
+			FMemory::Free(Data);
+		}
+
+		// The request can not be deleted from its own callback : release it from the game thread, read or not
+		TWeakObjectPtr<UGravityFieldAsset> WeakThis(this);
+		AsyncTask(ENamedThreads::GameThread, [WeakThis, Request]()
+		{
+			if (WeakThis.IsValid() && WeakThis->ReadRequest == Request)
+			{
+				WeakThis->ReleaseReadRequest();
+			}
+		});
+	};
+
+	ReadRequest = ReadFileHandle->ReadRequest(BrickData.GetBulkDataOffsetInFile(), BulkDataSize, AIOP_Normal, &ReadCallback);
+}
+
+bool UGravityFieldAsset::SampleGravityDirection(const FVector& LocalLocation, FVector& OutGravityDirection) const
+{
+	if (!IsFieldLoaded())
+	{
+		return false;
+	}
+
+	const FVector GridLocation = (LocalLocation - FieldOrigin) * InvCellSize;
+	if (GridLocation.X < 0.0f || GridLocation.Y < 0.0f || GridLocation.Z < 0.0f)
+	{
+		return false;
+	}
+
+	const int32 CellX = FMath::TruncToInt(GridLocation.X);
+	const int32 CellY = FMath::TruncToInt(GridLocation.Y);
+	const int32 CellZ = FMath::TruncToInt(GridLocation.Z);
+
+	const int32 BrickX = CellX / BrickCells;
+	const int32 BrickY = CellY / BrickCells;
+	const int32 BrickZ = CellZ / BrickCells;
+
+	if (BrickX >= BrickGridSize.X || BrickY >= BrickGridSize.Y || BrickZ >= BrickGridSize.Z)
+	{
+		return false;
+	}
+
+	const int32 Brick = BrickIndices[(BrickZ * BrickGridSize.Y + BrickY) * BrickGridSize.X + BrickX];
+	if (Brick == INDEX_NONE)
+	{
+		return false;
+	}
+
+	const int32 StrideX = 3;
+	const int32 StrideY = BrickSamples * StrideX;
+	const int32 StrideZ = BrickSamples * StrideY;
+
+	const int32 LocalX = CellX - BrickX * BrickCells;
+	const int32 LocalY = CellY - BrickY * BrickCells;
+	const int32 LocalZ = CellZ - BrickZ * BrickCells;
+
+	const int8* Base = Samples.GetData() + Brick * SamplesPerBrick * StrideX + LocalZ * StrideZ + LocalY * StrideY + LocalX * StrideX;
+
+	const float AlphaX = GridLocation.X - CellX;
+	const float AlphaY = GridLocation.Y - CellY;
+	const float AlphaZ = GridLocation.Z - CellZ;
+
+	auto LerpX = [AlphaX](const int8* Sample)
+	{
+		return FMath::Lerp(FVector(Sample[0], Sample[1], Sample[2]), FVector(Sample[3], Sample[4], Sample[5]), AlphaX);
+	};
+
+	const FVector Bottom = FMath::Lerp(LerpX(Base), LerpX(Base + StrideY), AlphaY);
+	const FVector Top = FMath::Lerp(LerpX(Base + StrideZ), LerpX(Base + StrideZ + StrideY), AlphaY);
+	const FVector Direction = FMath::Lerp(Bottom, Top, AlphaZ);
+
+	// Quantization scale cancels out with the normalization
+	const float SizeSquared = Direction.SizeSquared();
+	if (SizeSquared < SMALL_NUMBER)
+	{
+		return false;
+	}
+
+	OutGravityDirection = Direction * FMath::InvSqrt(SizeSquared);
+	return true;
+}
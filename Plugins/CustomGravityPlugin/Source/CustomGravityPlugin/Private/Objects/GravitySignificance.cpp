@@ -0,0 +1,227 @@
+// Copyright 2015 Elhoussine Mehnik (Mhousse1247). All Rights Reserved.
+//******************* http://ue4resources.com/ *********************//
+
+
+#include "CustomGravityPluginPrivatePCH.h"
+
+static TAutoConsoleVariable<int32> CVarSignificance(
+	TEXT("CustomGravity.Significance"),
+	0,
+	TEXT("0 : every gravity pawn and gravity body is updated at full rate (default).\n")
+	TEXT("1 : gravity pawns and gravity bodies are ranked by distance and view relevance to the local players, lower tiers are updated less often."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarSignificanceMediumDistance(
+	TEXT("CustomGravity.SignificanceMediumDistance"),
+	2500.0f,
+	TEXT("Distance to the closest local player view point beyond which objects drop to the medium tier."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarSignificanceLowDistance(
+	TEXT("CustomGravity.SignificanceLowDistance"),
+	6000.0f,
+	TEXT("Distance to the closest local player view point beyond which objects drop to the low tier."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarSignificanceUpdateInterval(
+	TEXT("CustomGravity.SignificanceUpdateInterval"),
+	0.25f,
+	TEXT("Time in seconds between two rankings."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<int32> CVarSignificanceDebug(
+	TEXT("CustomGravity.SignificanceDebug"),
+	0,
+	TEXT("1 : draws the tier of every ranked gravity pawn and gravity body (green high, yellow medium, red low)."),
+	ECVF_Cheat);
+
+/** Pawn actor and mesh tick intervals, per tier. */
+static const float SignificanceTickIntervals[] = { 0.0f, 1.0f / 30.0f, 0.1f };
+
+/** Frames between two point gravity evaluations of a gravity body, per tier. */
+static const uint32 SignificanceGravityUpdateFrames[] = { 1, 2, 4 };
+
+/** View cone margin, so objects at the edges of the screen are not demoted. */
+static const float SignificanceViewConeMargin = 10.0f;
+
+
+FGravitySignificanceManager::FGravitySignificanceManager()
+	: TimeToNextUpdate(0.0f)
+	, bHasReducedTiers(false)
+{
+}
+
+void FGravitySignificanceManager::AddPawn(AGravityPawn* Pawn)
+{
+	Pawns.AddUnique(Pawn);
+}
+
+void FGravitySignificanceManager::RemovePawn(AGravityPawn* Pawn)
+{
+	Pawns.RemoveSingleSwap(Pawn, false);
+}
+
+bool FGravitySignificanceManager::IsEnabled()
+{
+	return CVarSignificance.GetValueOnGameThread() != 0;
+}
+
+bool FGravitySignificanceManager::ShouldDrawDebug()
+{
+	return IsEnabled() && CVarSignificanceDebug.GetValueOnGameThread() != 0;
+}
+
+float FGravitySignificanceManager::GetTickInterval(EGravitySignificance::Type Tier)
+{
+	return SignificanceTickIntervals[Tier];
+}
+
+uint32 FGravitySignificanceManager::GetGravityUpdateFrames(EGravitySignificance::Type Tier)
+{
+	return SignificanceGravityUpdateFrames[Tier];
+}
+
+bool FGravitySignificanceManager::Update(UWorld* World, float DeltaTime)
+{
+	if (!IsEnabled())
+	{
+		if (!bHasReducedTiers)
+		{
+			return false;
+		}
+
+		// Back to full rate
+		bHasReducedTiers = false;
+		TimeToNextUpdate = 0.0f;
+		ViewPoints.Reset();
+	}
+	else
+	{
+		TimeToNextUpdate -= DeltaTime;
+		if (TimeToNextUpdate > 0.0f)
+		{
+#if ENABLE_DRAW_DEBUG
+			if (ShouldDrawDebug())
+			{
+				for (const TWeakObjectPtr<AGravityPawn>& Pawn : Pawns)
+				{
+					if (Pawn.IsValid())
+					{
+						DrawDebugTier(World, Pawn->GetActorLocation(), Pawn->GetSimpleCollisionRadius(), Pawn->GetSignificance());
+					}
+				}
+			}
+#endif
+			return false;
+		}
+
+		TimeToNextUpdate = CVarSignificanceUpdateInterval.GetValueOnGameThread();
+		bHasReducedTiers = true;
+		GatherViewPoints(World);
+	}
+
+	for (int32 Index = Pawns.Num() - 1; Index >= 0; --Index)
+	{
+		AGravityPawn* Pawn = Pawns[Index].Get();
+		if (Pawn == nullptr)
+		{
+			Pawns.RemoveAtSwap(Index, 1, false);
+			continue;
+		}
+
+		// The pawns the local players control are always at full rate
+		const EGravitySignificance::Type Tier = Pawn->IsLocallyControlled() ? EGravitySignificance::EGS_High
+			: Evaluate(Pawn->GetActorLocation(), Pawn->GetSimpleCollisionRadius(), Pawn->WasRecentlyRendered());
+
+		Pawn->SetSignificance(Tier);
+
+#if ENABLE_DRAW_DEBUG
+		if (ShouldDrawDebug())
+		{
+			DrawDebugTier(World, Pawn->GetActorLocation(), Pawn->GetSimpleCollisionRadius(), Tier);
+		}
+#endif
+	}
+
+	return true;
+}
+
+void FGravitySignificanceManager::GatherViewPoints(UWorld* World)
+{
+	ViewPoints.Reset();
+
+	for (FConstPlayerControllerIterator It = World->GetPlayerControllerIterator(); It; ++It)
+	{
+		APlayerController* PlayerController = It->Get();
+		if (PlayerController == nullptr || !PlayerController->IsLocalController())
+		{
+			continue;
+		}
+
+		FVector ViewLocation;
+		FRotator ViewRotation;
+		PlayerController->GetPlayerViewPoint(ViewLocation, ViewRotation);
+
+		const float FOVAngle = PlayerController->PlayerCameraManager ? PlayerController->PlayerCameraManager->GetFOVAngle() : 90.0f;
+
+		FViewPoint& ViewPoint = ViewPoints[ViewPoints.AddUninitialized()];
+		ViewPoint.Location = ViewLocation;
+		ViewPoint.Direction = ViewRotation.Vector();
+		ViewPoint.ViewConeCos = FMath::Cos(FMath::DegreesToRadians(FMath::Min(FOVAngle * 0.5f + SignificanceViewConeMargin, 89.0f)));
+	}
+}
+
+EGravitySignificance::Type FGravitySignificanceManager::Evaluate(const FVector& Location, float Radius, bool bRecentlyRendered) const
+{
+	// No local player (dedicated server) : nothing to rank against
+	if (!IsEnabled() || ViewPoints.Num() == 0)
+	{
+		return EGravitySignificance::EGS_High;
+	}
+
+	float MinDistance = BIG_NUMBER;
+	bool bInView = bRecentlyRendered;
+
+	for (const FViewPoint& ViewPoint : ViewPoints)
+	{
+		const FVector Delta = Location - ViewPoint.Location;
+		const float Distance = Delta.Size();
+		MinDistance = FMath::Min(MinDistance, Distance);
+
+		if (!bInView)
+		{
+			bInView = Distance <= Radius || FVector::DotProduct(Delta, ViewPoint.Direction) + Radius >= ViewPoint.ViewConeCos * Distance;
+		}
+	}
+
+	const float SurfaceDistance = MinDistance - Radius;
+
+	int32 Tier = EGravitySignificance::EGS_High;
+	if (SurfaceDistance > CVarSignificanceLowDistance.GetValueOnGameThread())
+	{
+		Tier = EGravitySignificance::EGS_Low;
+	}
+	else if (SurfaceDistance > CVarSignificanceMediumDistance.GetValueOnGameThread())
+	{
+		Tier = EGravitySignificance::EGS_Medium;
+	}
+
+	// Out of view : one tier lower
+	if (!bInView)
+	{
+		Tier = FMath::Min<int32>(Tier + 1, EGravitySignificance::EGS_Low);
+	}
+
+	return (EGravitySignificance::Type)Tier;
+}
+
+#if ENABLE_DRAW_DEBUG
+void FGravitySignificanceManager::DrawDebugTier(UWorld* World, const FVector& Location, float Radius, EGravitySignificance::Type Tier)
+{
+	static const FColor TierColors[] = { FColor::Green, FColor::Yellow, FColor::Red };
+	static const TCHAR* TierNames[] = { TEXT("High"), TEXT("Medium"), TEXT("Low") };
+
+	DrawDebugSphere(World, Location, Radius, 8, TierColors[Tier], false, -1.0f);
+	DrawDebugString(World, Location, TierNames[Tier], nullptr, TierColors[Tier], 0.0f);
+}
+#endif
@@ -0,0 +1,188 @@
+// Copyright 2015 Elhoussine Mehnik (Mhousse1247). All Rights Reserved.
+//******************* http://ue4resources.com/ *********************//
+
+
+#include "CustomGravityPluginPrivatePCH.h"
+#include "Async/ParallelFor.h"
+
+
+FGravityTrajectorySolver::FGravityTrajectorySolver()
+	: Planet(nullptr)
+	, ConstantAcceleration(FVector::ZeroVector)
+	, PlanetAccelerationScale(1.0f)
+	, TimeStep(0.05f)
+	, MaxSteps(60)
+	, SweepStride(4)
+	, Shape(FCollisionShape::MakeSphere(10.0f))
+	, TraceChannel(ECC_Visibility)
+	, QueryParams(SCENE_QUERY_STAT(GravityTrajectory), true)
+	, WalkableNormalDot(0.75f)
+{
+}
+
+FVector FGravityTrajectorySolver::GetGravityAcceleration(const FVector& Location) const
+{
+	if (Planet == nullptr)
+	{
+		return ConstantAcceleration;
+	}
+
+	const FGravityInfo GravityInfo = Planet->GetGravityinfo(Location);
+	return GravityInfo.GravityDirection * GravityInfo.GravityPower * PlanetAccelerationScale;
+}
+
+void FGravityTrajectorySolver::IntegratePath(const FVector& Start, const FVector& Velocity, FVector* OutLocations, FVector* OutVelocities) const
+{
+	FVector Location = Start;
+	FVector CurrentVelocity = Velocity;
+
+	OutLocations[0] = Location;
+	OutVelocities[0] = CurrentVelocity;
+
+	// Semi-implicit Euler, the gravity direction follows the planet along the path
+	for (int32 Step = 1; Step <= MaxSteps; ++Step)
+	{
+		CurrentVelocity += GetGravityAcceleration(Location) * TimeStep;
+		Location += CurrentVelocity * TimeStep;
+
+		OutLocations[Step] = Location;
+		OutVelocities[Step] = CurrentVelocity;
+	}
+}
+
+FQuat FGravityTrajectorySolver::GetShapeRotation(const FVector& Location) const
+{
+	const FVector UpVector = -GetGravityAcceleration(Location).GetSafeNormal();
+	return UpVector.IsZero() ? FQuat::Identity : FQuat::FindBetweenNormals(FVector::UpVector, UpVector);
+}
+
+bool FGravityTrajectorySolver::SweepSegment(UWorld* World, const FVector& Start, const FVector& End, FHitResult& OutHit) const
+{
+	// Overlaps at the start of a segment are the surface the path leaves (launch)
+	return World->SweepSingleByChannel(OutHit, Start, End, GetShapeRotation(Start), TraceChannel, Shape, QueryParams) && !OutHit.bStartPenetrating;
+}
+
+bool FGravityTrajectorySolver::TestChord(UWorld* World, const FVector* Locations, int32 FirstStep, int32 LastStep) const
+{
+	// The steps lie on a parabola : none is further from the chord than |g| * T^2 / 8
+	const float Duration = (LastStep - FirstStep) * TimeStep;
+	const float MaxAcceleration = FMath::Max(GetGravityAcceleration(Locations[FirstStep]).Size(), GetGravityAcceleration(Locations[LastStep]).Size());
+	const float Sag = MaxAcceleration * FMath::Square(Duration) / 8.0f;
+
+	// The steps rotate with the gravity : the chord is swept with a sphere bounding the shape in any orientation
+	float BoundingRadius = 0.0f;
+	switch (Shape.ShapeType)
+	{
+	case ECollisionShape::Box:
+		BoundingRadius = Shape.GetBox().Size();
+		break;
+	case ECollisionShape::Sphere:
+		BoundingRadius = Shape.GetSphereRadius();
+		break;
+	case ECollisionShape::Capsule:
+		// Half height includes the hemispheres
+		BoundingRadius = Shape.GetCapsuleHalfHeight();
+		break;
+	default:
+		break;
+	}
+
+	// Overlaps at the start are kept : the inflated shape may touch the launch surface while the steps hit something further
+	return World->SweepTestByChannel(Locations[FirstStep], Locations[LastStep], FQuat::Identity, TraceChannel, FCollisionShape::MakeSphere(BoundingRadius + Sag), QueryParams);
+}
+
+bool FGravityTrajectorySolver::SweepPath(UWorld* World, const FVector* Locations, const FVector* Velocities, FGravityJumpPrediction& OutPrediction) const
+{
+	OutPrediction = FGravityJumpPrediction();
+
+	const int32 Stride = FMath::Max(SweepStride, 1);
+	FHitResult Hit;
+
+	for (int32 SegmentStart = 0; SegmentStart < MaxSteps; SegmentStart += Stride)
+	{
+		const int32 SegmentEnd = FMath::Min(SegmentStart + Stride, MaxSteps);
+
+		int32 HitStep = SegmentStart;
+		if (SegmentEnd - SegmentStart == 1)
+		{
+			if (!SweepSegment(World, Locations[SegmentStart], Locations[SegmentEnd], Hit))
+			{
+				continue;
+			}
+		}
+		else
+		{
+			// One test along the chord of several steps, refined step by step if it may hit
+			if (!TestChord(World, Locations, SegmentStart, SegmentEnd))
+			{
+				continue;
+			}
+
+			HitStep = INDEX_NONE;
+			for (int32 Step = SegmentStart; Step < SegmentEnd; ++Step)
+			{
+				if (SweepSegment(World, Locations[Step], Locations[Step + 1], Hit))
+				{
+					HitStep = Step;
+					break;
+				}
+			}
+
+			// The inflated chord touched something the steps go around
+			if (HitStep == INDEX_NONE)
+			{
+				continue;
+			}
+		}
+
+		const FVector UpVector = -GetGravityAcceleration(Hit.Location).GetSafeNormal();
+
+		OutPrediction.bLands = true;
+		OutPrediction.bLandsOnWalkableSurface = FVector::DotProduct(Hit.ImpactNormal, UpVector) > WalkableNormalDot;
+		OutPrediction.LandingLocation = Hit.Location;
+		OutPrediction.ImpactPoint = Hit.ImpactPoint;
+		OutPrediction.ImpactNormal = Hit.ImpactNormal;
+		OutPrediction.LandingTime = (HitStep + Hit.Time) * TimeStep;
+		OutPrediction.LandingVelocity = FMath::Lerp(Velocities[HitStep], Velocities[HitStep + 1], Hit.Time);
+		OutPrediction.LandingActor = Hit.GetActor();
+		return true;
+	}
+
+	OutPrediction.LandingLocation = Locations[MaxSteps];
+	OutPrediction.LandingTime = MaxSteps * TimeStep;
+	OutPrediction.LandingVelocity = Velocities[MaxSteps];
+	return false;
+}
+
+bool FGravityTrajectorySolver::Predict(UWorld* World, const FVector& Start, const FVector& Velocity, FGravityJumpPrediction& OutPrediction) const
+{
+	TArray<FVector, TInlineAllocator<128>> Locations;
+	TArray<FVector, TInlineAllocator<128>> Velocities;
+	Locations.SetNumUninitialized(MaxSteps + 1);
+	Velocities.SetNumUninitialized(MaxSteps + 1);
+
+	IntegratePath(Start, Velocity, Locations.GetData(), Velocities.GetData());
+	return SweepPath(World, Locations.GetData(), Velocities.GetData(), OutPrediction);
+}
+
+void FGravityTrajectorySolver::PredictBatch(UWorld* World, const FVector& Start, const TArray<FVector>& Velocities, TArray<FGravityJumpPrediction>& OutPredictions) const
+{
+	const int32 NumPaths = Velocities.Num();
+	const int32 NumPoints = MaxSteps + 1;
+
+	TArray<FVector> PathLocations;
+	TArray<FVector> PathVelocities;
+	PathLocations.SetNumUninitialized(NumPaths * NumPoints);
+	PathVelocities.SetNumUninitialized(NumPaths * NumPoints);
+
+	ParallelFor(NumPaths, [&](int32 Path)
+	{
+		IntegratePath(Start, Velocities[Path], &PathLocations[Path * NumPoints], &PathVelocities[Path * NumPoints]);
+	});
+
+	OutPredictions.SetNum(NumPaths);
+	for (int32 Path = 0; Path < NumPaths; ++Path)
+	{
+		SweepPath(World, &PathLocations[Path * NumPoints], &PathVelocities[Path * NumPoints], OutPredictions[Path]);
+	}
+}
@@ -0,0 +1,185 @@
+// Copyright 2015 Elhoussine Mehnik (Mhousse1247). All Rights Reserved.
+//******************* http://ue4resources.com/ *********************//
+
+
+#include "CustomGravityPluginPrivatePCH.h"
+
+
+FPlanetRegistry::FPlanetRegistry()
+	: bNeedsRebuild(false)
+{
+}
+
+void FPlanetRegistry::AddPlanet(APlanetActor* Planet)
+{
+	if (Planet == nullptr)
+	{
+		return;
+	}
+
+	for (const FPlanetEntry& Entry : Planets)
+	{
+		if (Entry.Planet == Planet)
+		{
+			return;
+		}
+	}
+
+	FPlanetEntry Entry;
+	Entry.Planet = Planet;
+	Entry.Center = Planet->GetActorLocation();
+	Entry.Radius = Planet->SphereOfInfluenceRadius;
+	Planets.Add(Entry);
+
+	bNeedsRebuild = true;
+}
+
+void FPlanetRegistry::RemovePlanet(APlanetActor* Planet)
+{
+	for (int32 Index = 0; Index < Planets.Num(); ++Index)
+	{
+		if (Planets[Index].Planet == Planet)
+		{
+			Planets.RemoveAtSwap(Index);
+			bNeedsRebuild = true;
+			return;
+		}
+	}
+}
+
+void FPlanetRegistry::Update()
+{
+	// Planets are few : checking them all every frame is cheap and lets them move at runtime
+	for (FPlanetEntry& Entry : Planets)
+	{
+		const FVector Center = Entry.Planet->GetActorLocation();
+		const float Radius = Entry.Planet->SphereOfInfluenceRadius;
+
+		if (!Center.Equals(Entry.Center) || Radius != Entry.Radius)
+		{
+			Entry.Center = Center;
+			Entry.Radius = Radius;
+			bNeedsRebuild = true;
+		}
+	}
+
+	if (bNeedsRebuild)
+	{
+		Build();
+		bNeedsRebuild = false;
+	}
+}
+
+void FPlanetRegistry::Build()
+{
+	Nodes.Reset();
+	PlanetOrder.Reset();
+
+	for (int32 Index = 0; Index < Planets.Num(); ++Index)
+	{
+		// Planets without sphere of influence are never selected automatically
+		if (Planets[Index].Radius > 0.0f)
+		{
+			PlanetOrder.Add(Index);
+		}
+	}
+
+	if (PlanetOrder.Num() > 0)
+	{
+		Nodes.Reserve(PlanetOrder.Num() * 2 - 1);
+		BuildNode(0, PlanetOrder.Num());
+	}
+}
+
+int32 FPlanetRegistry::BuildNode(int32 Start, int32 Num)
+{
+	const int32 NodeIndex = Nodes.AddUninitialized();
+
+	FBox Bounds(ForceInit);
+	FBox CenterBounds(ForceInit);
+	for (int32 Index = Start; Index < Start + Num; ++Index)
+	{
+		const FPlanetEntry& Entry = Planets[PlanetOrder[Index]];
+		Bounds += FBox(Entry.Center - FVector(Entry.Radius), Entry.Center + FVector(Entry.Radius));
+		CenterBounds += Entry.Center;
+	}
+
+	Nodes[NodeIndex].Bounds = Bounds;
+
+	if (Num == 1)
+	{
+		Nodes[NodeIndex].Children[0] = INDEX_NONE;
+		Nodes[NodeIndex].Children[1] = INDEX_NONE;
+		Nodes[NodeIndex].PlanetIndex = PlanetOrder[Start];
+		return NodeIndex;
+	}
+
+	// Median split along the longest axis of the centers bounds
+	const FVector Extent = CenterBounds.GetExtent();
+	const int32 Axis = (Extent.X >= Extent.Y && Extent.X >= Extent.Z) ? 0 : (Extent.Y >= Extent.Z ? 1 : 2);
+
+	const TArray<FPlanetEntry>& Entries = Planets;
+	Sort(PlanetOrder.GetData() + Start, Num, [&Entries, Axis](int32 A, int32 B)
+	{
+		return Entries[A].Center[Axis] < Entries[B].Center[Axis];
+	});
+
+	const int32 NumLeft = Num / 2;
+	const int32 LeftChild = BuildNode(Start, NumLeft);
+	const int32 RightChild = BuildNode(Start + NumLeft, Num - NumLeft);
+
+	Nodes[NodeIndex].Children[0] = LeftChild;
+	Nodes[NodeIndex].Children[1] = RightChild;
+	Nodes[NodeIndex].PlanetIndex = INDEX_NONE;
+	return NodeIndex;
+}
+
+APlanetActor* FPlanetRegistry::FindDominantPlanet(const FVector& Location, APlanetActor* CurrentPlanet, float Hysteresis) const
+{
+	// Current planet influence, with an extended sphere of influence so bodies near the boundary do not flicker
+	const float CurrentInfluence = CurrentPlanet != nullptr ? CurrentPlanet->GetInfluence(Location, 1.0f + Hysteresis) : 0.0f;
+
+	APlanetActor* BestPlanet = nullptr;
+	float BestInfluence = 0.0f;
+
+	if (Nodes.Num() > 0)
+	{
+		int32 Stack[64];
+		int32 StackSize = 0;
+		Stack[StackSize++] = 0;
+
+		while (StackSize > 0)
+		{
+			const FNode& Node = Nodes[Stack[--StackSize]];
+
+			if (!Node.Bounds.IsInsideOrOn(Location))
+			{
+				continue;
+			}
+
+			if (Node.PlanetIndex != INDEX_NONE)
+			{
+				APlanetActor* Planet = Planets[Node.PlanetIndex].Planet;
+				const float Influence = (Planet == CurrentPlanet) ? CurrentInfluence : Planet->GetInfluence(Location);
+
+				if (Influence > BestInfluence)
+				{
+					BestInfluence = Influence;
+					BestPlanet = Planet;
+				}
+				continue;
+			}
+
+			check(StackSize + 2 <= ARRAY_COUNT(Stack));
+			Stack[StackSize++] = Node.Children[0];
+			Stack[StackSize++] = Node.Children[1];
+		}
+	}
+
+	if (CurrentInfluence > 0.0f && BestInfluence <= CurrentInfluence * (1.0f + Hysteresis))
+	{
+		return CurrentPlanet;
+	}
+
+	return BestPlanet;
+}
@@ -14,6 +14,7 @@ AGravityCharacter::AGravityCharacter(const FObjectInitializer& ObjectInitializer
 	MinVelocityToRotateMesh = 2.0f;
 	bInstantRotation = true;
 	RotationInterpSpeed = 5.0f;
+	MeshRotationYawTolerance = 0.5f;
 }
 
 // Called when the game starts or when spawned
@@ -34,14 +35,27 @@ void AGravityCharacter::UpdateMeshRotation(float DeltaTime)
 		return;
 	}
 
-	FRotator MeshRotation = GetMesh()->RelativeRotation;
-	const FVector ProjectedVelocity = FVector::VectorPlaneProject(GetMovementComponent()->Velocity, GetActorUpVector());
-	const FRotator Rot = FRotationMatrix::MakeFromXZ(GetTransform().InverseTransformVector(ProjectedVelocity), GetActorUpVector()).Rotator();
+	const FRotator CurrentMeshRotation = GetMesh()->RelativeRotation;
+	FRotator MeshRotation = CurrentMeshRotation;
 
-	MeshRotation.Yaw = MeshOrientation == EMeshOrientation::EMO_Movement ?
-		MeshStartRotation.Yaw + Rot.Yaw :
-		MeshStartRotation.Yaw + GetSpringArm()->RelativeRotation.Yaw;
+	if (MeshOrientation == EMeshOrientation::EMO_Movement)
+	{
+		const FVector ProjectedVelocity = FVector::VectorPlaneProject(GetMovementComponent()->Velocity, GetActorUpVector());
+		const FRotator Rot = FRotationMatrix::MakeFromXZ(GetTransform().InverseTransformVector(ProjectedVelocity), GetActorUpVector()).Rotator();
+		MeshRotation.Yaw = MeshStartRotation.Yaw + Rot.Yaw;
+	}
+	else
+	{
+		MeshRotation.Yaw = MeshStartRotation.Yaw + GetSpringArm()->RelativeRotation.Yaw;
+	}
 
-	GetMesh()->RelativeRotation = bInstantRotation ? MeshRotation : FMath::RInterpTo(GetMesh()->RelativeRotation, MeshRotation, DeltaTime, RotationInterpSpeed);
+	// Only the yaw changes : skip the transform update while it is close enough
+	if (FMath::Abs(FRotator::NormalizeAxis(MeshRotation.Yaw - CurrentMeshRotation.Yaw)) <= MeshRotationYawTolerance)
+	{
+		INC_DWORD_STAT(STAT_NumPawnTransformUpdatesAvoided);
+		return;
+	}
 
+	GetMesh()->SetRelativeRotation(bInstantRotation ? MeshRotation : FMath::RInterpTo(CurrentMeshRotation, MeshRotation, DeltaTime, RotationInterpSpeed));
+	INC_DWORD_STAT(STAT_NumPawnTransformUpdates);
 }
\ No newline at end of file
@@ -50,6 +50,9 @@ AGravityPawn::AGravityPawn(const FObjectInitializer& ObjectInitializer) : Super(
 	if (PawnMesh)
 	{
 		PawnMesh->MeshComponentUpdateFlag = EMeshComponentUpdateFlag::AlwaysTickPose;
+		// The update rate parameters are created when the mesh registers, before PostInitializeComponents
+		PawnMesh->bEnableUpdateRateOptimizations = true;
+		PawnMesh->OnAnimUpdateRateParamsCreated.BindUObject(this, &AGravityPawn::OnAnimUpdateRateParamsCreated);
 		PawnMesh->bCastDynamicShadow = true;
 		PawnMesh->bAffectDynamicIndirectLighting = true;
 		PawnMesh->PrimaryComponentTick.TickGroup = TG_PrePhysics;
@@ -115,6 +118,17 @@ AGravityPawn::AGravityPawn(const FObjectInitializer& ObjectInitializer) : Super(
 
 	CameraPitchMin = -89.0f;
 	CameraPitchMax = 89.0f;
+
+	bUseAnimationUpdateRateOptimizations = true;
+	bOnlyTickPoseWhenRenderedIfRemote = true;
+	NonRenderedAnimUpdateRate = 4;
+	MaxAnimEvalRateForInterpolation = 4;
+
+	bIsDebugging = false;
+	Significance = EGravitySignificance::EGS_High;
+	BaseActorTickInterval = 0.0f;
+	BaseMeshTickInterval = 0.0f;
+	LastTickFrame = 0;
 }
 
 void AGravityPawn::PostInitializeComponents()
@@ -127,10 +141,19 @@ void AGravityPawn::PostInitializeComponents()
 		{
 
 			// force animation tick after movement component updates
+			// With the batched movement pass, the gravity manager also makes the mesh tick after the pass that rotates the capsule
 			if (PawnMesh->PrimaryComponentTick.bCanEverTick && MovementComponent)
 			{
 				PawnMesh->PrimaryComponentTick.AddPrerequisite(MovementComponent, MovementComponent->PrimaryComponentTick);
 			}
+
+			// Enabled by default in the constructor : pawns opting out only turn them off
+			if (!bUseAnimationUpdateRateOptimizations)
+			{
+				PawnMesh->bEnableUpdateRateOptimizations = false;
+			}
+
+			UpdateMeshTickPoseMode();
 		}
 	}
 
@@ -141,18 +164,147 @@ void AGravityPawn::PostInitializeComponents()
 // Called every frame
 void AGravityPawn::Tick(float DeltaTime)
 {
+	SCOPE_CUSTOM_GRAVITY_TICK_TIMER();
+
 	Super::Tick(DeltaTime);
 
+	// Frames skipped by the significance tick interval, shared by the actor and the mesh
+	if (Significance != EGravitySignificance::EGS_High && LastTickFrame != 0 && GFrameCounter > LastTickFrame + 1)
+	{
+		const uint32 TicksSaved = (GFrameCounter - LastTickFrame - 1) * (PawnMesh && PawnMesh->IsComponentTickEnabled() ? 2 : 1);
+		INC_DWORD_STAT_BY(STAT_NumSignificanceTicksSaved, TicksSaved);
+		GCustomGravitySignificanceTicksSaved += TicksSaved;
+	}
+	LastTickFrame = GFrameCounter;
+
 	UpdateMeshRotation(DeltaTime);
 
-	GizmoRootComponent->SetWorldRotation(FRotationMatrix::MakeFromXZ(CurrentForwardDirection, GetActorUpVector()).Rotator());
+	// The gizmo is hidden in game unless debugging
+	if (bIsDebugging)
+	{
+		UpdateGizmoRotation();
+	}
+	else
+	{
+		INC_DWORD_STAT(STAT_NumPawnTransformUpdatesAvoided);
+	}
+}
+
+
+void AGravityPawn::UpdateGizmoRotation()
+{
+	if (GizmoRootComponent == NULL) { return; }
+
+	const FQuat GizmoRotation = FRotationMatrix::MakeFromXZ(CurrentForwardDirection, GetActorUpVector()).ToQuat();
+
+	if (GizmoRootComponent->GetComponentQuat().Equals(GizmoRotation))
+	{
+		INC_DWORD_STAT(STAT_NumPawnTransformUpdatesAvoided);
+		return;
+	}
 
+	GizmoRootComponent->SetWorldRotation(GizmoRotation);
+	INC_DWORD_STAT(STAT_NumPawnTransformUpdates);
 }
 
 
 void AGravityPawn::BeginPlay()
 {
 	Super::BeginPlay();
+
+	BaseActorTickInterval = GetActorTickInterval();
+	BaseMeshTickInterval = PawnMesh ? PawnMesh->GetComponentTickInterval() : 0.0f;
+
+	AGravityWorldManager* GravityManager = AGravityWorldManager::Get(this);
+	if (GravityManager != nullptr)
+	{
+		GravityManager->GetSignificanceManager().AddPawn(this);
+	}
+}
+
+
+void AGravityPawn::PossessedBy(AController* NewController)
+{
+	Super::PossessedBy(NewController);
+
+	UpdateMeshTickPoseMode();
+}
+
+
+void AGravityPawn::UnPossessed()
+{
+	Super::UnPossessed();
+
+	UpdateMeshTickPoseMode();
+}
+
+
+void AGravityPawn::OnRep_Controller()
+{
+	Super::OnRep_Controller();
+
+	UpdateMeshTickPoseMode();
+}
+
+
+void AGravityPawn::UpdateMeshTickPoseMode()
+{
+	if (PawnMesh == NULL) { return; }
+
+	// The pose of the local player pawn drives its camera and gameplay, even off-screen
+	PawnMesh->MeshComponentUpdateFlag = (bOnlyTickPoseWhenRenderedIfRemote && !IsLocallyControlled()) ?
+		EMeshComponentUpdateFlag::OnlyTickPoseWhenRendered :
+		EMeshComponentUpdateFlag::AlwaysTickPose;
+}
+
+
+void AGravityPawn::OnAnimUpdateRateParamsCreated(FAnimUpdateRateParameters* Params)
+{
+	Params->bInterpolateSkippedFrames = true;
+	Params->BaseNonRenderedUpdateRate = FMath::Max(NonRenderedAnimUpdateRate, 1);
+	Params->MaxEvalRateForInterpolation = FMath::Max(MaxAnimEvalRateForInterpolation, 1);
+}
+
+
+void AGravityPawn::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	AGravityWorldManager* GravityManager = AGravityWorldManager::Find(this);
+	if (GravityManager != nullptr)
+	{
+		GravityManager->GetSignificanceManager().RemovePawn(this);
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
+
+void AGravityPawn::SetSignificance(EGravitySignificance::Type NewSignificance)
+{
+	if (Significance == NewSignificance)
+	{
+		return;
+	}
+
+	Significance = NewSignificance;
+
+	const float TickInterval = FGravitySignificanceManager::GetTickInterval(NewSignificance);
+	SetActorTickInterval(FMath::Max(BaseActorTickInterval, TickInterval));
+
+	if (PawnMesh != NULL)
+	{
+		PawnMesh->SetComponentTickInterval(FMath::Max(BaseMeshTickInterval, TickInterval));
+	}
+
+	if (MovementComponent != NULL)
+	{
+		MovementComponent->SetSignificance(NewSignificance);
+	}
+}
+
+
+EGravitySignificance::Type AGravityPawn::GetSignificance() const
+{
+	return Significance;
 }
 
 
@@ -246,6 +398,9 @@ void AGravityPawn::EnableDebugging()
 	if (CapsuleComponent != NULL) { CapsuleComponent->SetHiddenInGame(false); }
 	if (GizmoRootComponent != NULL) { GizmoRootComponent->SetHiddenInGame(false, true); }
 	if (MovementComponent != NULL) { MovementComponent->EnableDebuging(); }
+
+	bIsDebugging = true;
+	UpdateGizmoRotation();
 }
 
 
@@ -254,6 +409,8 @@ void AGravityPawn::DisableDebugging()
 	if (CapsuleComponent != NULL) { CapsuleComponent->SetHiddenInGame(true); }
 	if (GizmoRootComponent != NULL) { GizmoRootComponent->SetHiddenInGame(true, true); }
 	if (MovementComponent != NULL) { MovementComponent->DisableDebuging(); }
+
+	bIsDebugging = false;
 }
 
 
@@ -0,0 +1,67 @@
+// Copyright 2015 Elhoussine Mehnik (Mhousse1247). All Rights Reserved.
+//******************* http://ue4resources.com/ *********************//
+
+
+#include "CustomGravityPluginPrivatePCH.h"
+#include "Tests/CustomGravityTestWorld.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+const float FCustomGravityTestWorld::PlanetRadius = 5000.0f;
+
+FCustomGravityTestWorld::FCustomGravityTestWorld()
+	: Planet(nullptr)
+{
+	World = UWorld::CreateWorld(EWorldType::Game, false, TEXT("CustomGravityTestWorld"));
+
+	FWorldContext& WorldContext = GEngine->CreateNewWorldContext(EWorldType::Game);
+	WorldContext.SetCurrentWorld(World);
+
+	World->InitializeActorsForPlay(FURL());
+
+	// No game mode : begin play the way the game state would
+	World->GetWorldSettings()->NotifyBeginPlay();
+}
+
+FCustomGravityTestWorld::~FCustomGravityTestWorld()
+{
+	GEngine->DestroyWorldContext(World);
+	World->DestroyWorld(false);
+
+	CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+}
+
+void FCustomGravityTestWorld::Tick(float DeltaTime, int32 NumFrames)
+{
+	for (int32 Frame = 0; Frame < NumFrames; ++Frame)
+	{
+		World->Tick(LEVELTICK_All, DeltaTime);
+		++GFrameCounter;
+	}
+}
+
+AGravityPawn* FCustomGravityTestWorld::SpawnPawnOnPlanet(const FVector& Up, float Altitude)
+{
+	FActorSpawnParameters SpawnInfo;
+	SpawnInfo.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+
+	if (Planet == nullptr)
+	{
+		const FTransform PlanetTransform(FVector::ZeroVector);
+		Planet = World->SpawnActorDeferred<APlanetActor>(APlanetActor::StaticClass(), PlanetTransform);
+		Planet->CollisionType = ECollisionType::ECol_Sphere;
+		Planet->SphereCollisionRaduis = PlanetRadius;
+		Planet->SphereOfInfluenceRadius = PlanetRadius * 4.0f;
+		Planet->FinishSpawning(PlanetTransform);
+	}
+
+	const FVector Direction = Up.GetSafeNormal();
+	const FVector Location = Direction * (PlanetRadius + Altitude);
+
+	AGravityPawn* Pawn = World->SpawnActor<AGravityPawn>(Location, FRotationMatrix::MakeFromZ(Direction).Rotator(), SpawnInfo);
+	Pawn->GetMovementComponent()->CustomGravityType = EGravityType::EGT_Point;
+	Pawn->GetMovementComponent()->PlanetActor = Planet;
+	return Pawn;
+}
+
+#endif
@@ -0,0 +1,41 @@
+// Copyright 2015 Elhoussine Mehnik (Mhousse1247). All Rights Reserved.
+//******************* http://ue4resources.com/ *********************//
+
+#pragma once
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+/**
+* Game world used by the plugin automation tests.
+* Created with physics and begun play, ticked by hand with Tick(), destroyed with the object.
+*/
+class FCustomGravityTestWorld
+{
+public:
+
+	FCustomGravityTestWorld();
+	~FCustomGravityTestWorld();
+
+	UWorld* GetWorld() const { return World; }
+
+	/** Ticks the world NumFrames times, physics included. */
+	void Tick(float DeltaTime, int32 NumFrames = 1);
+
+	/**
+	* Spawns a gravity pawn attracted by a sphere planet at the world origin, the planet is spawned with the first pawn.
+	* The pawn is spawned Altitude above the planet surface, along Up.
+	*/
+	class AGravityPawn* SpawnPawnOnPlanet(const FVector& Up, float Altitude = 100.0f);
+
+	/** Planet spawned by SpawnPawnOnPlanet, null before that. */
+	class APlanetActor* GetPlanet() const { return Planet; }
+
+	static const float PlanetRadius;
+
+private:
+
+	UWorld* World;
+	class APlanetActor* Planet;
+};
+
+#endif
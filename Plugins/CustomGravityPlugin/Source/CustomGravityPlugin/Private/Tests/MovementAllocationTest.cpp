@@ -0,0 +1,127 @@
+// Copyright 2015 Elhoussine Mehnik (Mhousse1247). All Rights Reserved.
+//******************* http://ue4resources.com/ *********************//
+
+
+#include "CustomGravityPluginPrivatePCH.h"
+#include "Tests/CustomGravityTestWorld.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace MovementAllocationTest
+{
+	/**
+	* Forwards everything to the allocator it replaces, and counts the game thread allocations made while counting.
+	* Installed as GMalloc for the duration of the measure only.
+	*/
+	class FCountingMalloc : public FMalloc
+	{
+	public:
+
+		explicit FCountingMalloc(FMalloc* InInnerMalloc)
+			: InnerMalloc(InInnerMalloc)
+			, bIsCounting(false)
+			, NumAllocations(0)
+		{
+		}
+
+		void StartCounting() { NumAllocations = 0; bIsCounting = true; }
+		void StopCounting() { bIsCounting = false; }
+		int32 GetNumAllocations() const { return NumAllocations; }
+
+		// FMalloc interface
+		virtual void* Malloc(SIZE_T Count, uint32 Alignment) override
+		{
+			CountAllocation();
+			return InnerMalloc->Malloc(Count, Alignment);
+		}
+
+		virtual void* Realloc(void* Original, SIZE_T Count, uint32 Alignment) override
+		{
+			if (Count > 0)
+			{
+				CountAllocation();
+			}
+			return InnerMalloc->Realloc(Original, Count, Alignment);
+		}
+
+		virtual void Free(void* Original) override { InnerMalloc->Free(Original); }
+		virtual SIZE_T QuantizeSize(SIZE_T Count, uint32 Alignment) override { return InnerMalloc->QuantizeSize(Count, Alignment); }
+		virtual bool GetAllocationSize(void* Original, SIZE_T& SizeOut) override { return InnerMalloc->GetAllocationSize(Original, SizeOut); }
+		virtual void Trim() override { InnerMalloc->Trim(); }
+		virtual void SetupTLSCachesOnCurrentThread() override { InnerMalloc->SetupTLSCachesOnCurrentThread(); }
+		virtual void ClearAndDisableTLSCachesOnCurrentThread() override { InnerMalloc->ClearAndDisableTLSCachesOnCurrentThread(); }
+		virtual void InitializeStatsMetadata() override { InnerMalloc->InitializeStatsMetadata(); }
+		virtual void UpdateStats() override { InnerMalloc->UpdateStats(); }
+		virtual void GetAllocatorStats(FGenericMemoryStats& OutStats) override { InnerMalloc->GetAllocatorStats(OutStats); }
+		virtual void DumpAllocatorStats(FOutputDevice& Ar) override { InnerMalloc->DumpAllocatorStats(Ar); }
+		virtual bool IsInternallyThreadSafe() const override { return InnerMalloc->IsInternallyThreadSafe(); }
+		virtual bool ValidateHeap() override { return InnerMalloc->ValidateHeap(); }
+		virtual const TCHAR* GetDescriptiveName() override { return InnerMalloc->GetDescriptiveName(); }
+		// End of FMalloc interface
+
+	private:
+
+		void CountAllocation()
+		{
+			// Other threads keep allocating while the movement ticks
+			if (bIsCounting && IsInGameThread())
+			{
+				++NumAllocations;
+			}
+		}
+
+		FMalloc* InnerMalloc;
+		bool bIsCounting;
+		int32 NumAllocations;
+	};
+}
+
+/**
+* A pawn standing on a planet ticks its Gravity Movement component without allocating.
+* The world is ticked between the measured movement ticks so physics and the other actors keep running, but only the movement tick is counted.
+*/
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FCustomGravityMovementAllocationTest, "CustomGravity.Movement.SteadyStateTickDoesNotAllocate", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FCustomGravityMovementAllocationTest::RunTest(const FString& Parameters)
+{
+	static const float DeltaTime = 1.0f / 60.0f;
+	static const int32 SettleFrames = 120;
+	static const int32 MeasuredFrames = 60;
+
+	FCustomGravityTestWorld TestWorld;
+
+	AGravityPawn* Pawn = TestWorld.SpawnPawnOnPlanet(FVector::UpVector);
+	UGravityMovementComponent* MovementComponent = Pawn->GetMovementComponent();
+
+	// Land, align the capsule and fill the cached query state
+	TestWorld.Tick(DeltaTime, SettleFrames);
+	TestFalse(TEXT("Pawn landed on the planet"), MovementComponent->bIsInAir);
+
+	// The measured ticks replace the regular ones
+	MovementComponent->SetComponentTickEnabled(false);
+
+	MovementAllocationTest::FCountingMalloc CountingMalloc(GMalloc);
+	int32 NumAllocations = 0;
+
+	for (int32 Frame = 0; Frame < MeasuredFrames; ++Frame)
+	{
+		TestWorld.Tick(DeltaTime);
+
+		FMalloc* const PreviousMalloc = GMalloc;
+		GMalloc = &CountingMalloc;
+		CountingMalloc.StartCounting();
+
+		MovementComponent->TickComponent(DeltaTime, LEVELTICK_All, &MovementComponent->PrimaryComponentTick);
+
+		CountingMalloc.StopCounting();
+		GMalloc = PreviousMalloc;
+
+		NumAllocations += CountingMalloc.GetNumAllocations();
+	}
+
+	TestEqual(FString::Printf(TEXT("Heap allocations in %d steady state movement ticks"), MeasuredFrames), NumAllocations, 0);
+
+	return true;
+}
+
+#endif
@@ -0,0 +1,148 @@
+// Copyright 2015 Elhoussine Mehnik (Mhousse1247). All Rights Reserved.
+//******************* http://ue4resources.com/ *********************//
+
+
+#include "CustomGravityPluginPrivatePCH.h"
+#include "CustomGravityBenchmarks.h"
+#include "Tests/CustomGravityTestWorld.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace MovementBatchTest
+{
+	static const int32 NumPawns = 64;
+	static const int32 NumFrames = 20;
+	static const float DeltaTime = 1.0f / 60.0f;
+
+	/** Pawns falling toward the planet from every side, tilted so their capsules have to rotate. */
+	void SpawnPawns(FCustomGravityTestWorld& TestWorld, TArray<AGravityPawn*>& OutPawns)
+	{
+		FRandomStream RandomStream(1247);
+
+		for (int32 Index = 0; Index < NumPawns; ++Index)
+		{
+			AGravityPawn* Pawn = TestWorld.SpawnPawnOnPlanet(RandomStream.GetUnitVector(), 2000.0f);
+			const FQuat Tilt(RandomStream.GetUnitVector(), FMath::DegreesToRadians(RandomStream.FRandRange(10.0f, 60.0f)));
+			Pawn->SetActorRotation(Tilt * Pawn->GetActorQuat(), ETeleportType::TeleportPhysics);
+			OutPawns.Add(Pawn);
+		}
+	}
+
+	/** Spawns the pawns with CustomGravity.BatchedMovementUpdate set to bBatched, then ticks them. */
+	void RunPawns(FCustomGravityTestWorld& TestWorld, bool bBatched, TArray<AGravityPawn*>& OutPawns)
+	{
+		IConsoleVariable* BatchedMovementUpdate = IConsoleManager::Get().FindConsoleVariable(TEXT("CustomGravity.BatchedMovementUpdate"));
+		const int32 PreviousValue = BatchedMovementUpdate->GetInt();
+
+		// Read when the components are initialized
+		BatchedMovementUpdate->Set(bBatched ? 1 : 0, ECVF_SetByCode);
+		SpawnPawns(TestWorld, OutPawns);
+		BatchedMovementUpdate->Set(PreviousValue, ECVF_SetByCode);
+
+		TestWorld.Tick(DeltaTime, NumFrames);
+	}
+}
+
+/**
+* The same pawns, in two worlds : one on the per-component path, the other on the batched movement pass.
+* Their capsule rotations and the velocities their gravity forces built up must match.
+*/
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FCustomGravityMovementBatchTest, "CustomGravity.Movement.BatchMatchesPerComponent", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FCustomGravityMovementBatchTest::RunTest(const FString& Parameters)
+{
+	static const float AngleTolerance = 0.001f;
+	static const float VelocityTolerance = 0.1f;
+
+	FCustomGravityTestWorld PerComponentWorld;
+	TArray<AGravityPawn*> PerComponentPawns;
+	MovementBatchTest::RunPawns(PerComponentWorld, false, PerComponentPawns);
+
+	FCustomGravityTestWorld BatchedWorld;
+	TArray<AGravityPawn*> BatchedPawns;
+	MovementBatchTest::RunPawns(BatchedWorld, true, BatchedPawns);
+
+	AGravityWorldManager* BatchedManager = AGravityWorldManager::Find(BatchedWorld.GetWorld());
+	TestTrue(TEXT("Batched pawns registered to the movement pass"), BatchedManager != nullptr && BatchedManager->GetNumMovementComponents() == MovementBatchTest::NumPawns);
+
+	float MaxAngleError = 0.0f;
+	float MaxVelocityError = 0.0f;
+	float MinFallingSpeed = MAX_flt;
+	for (int32 Index = 0; Index < MovementBatchTest::NumPawns; ++Index)
+	{
+		UCapsuleComponent* PerComponentCapsule = PerComponentPawns[Index]->GetCapsuleComponent();
+		UCapsuleComponent* BatchedCapsule = BatchedPawns[Index]->GetCapsuleComponent();
+
+		MaxAngleError = FMath::Max(MaxAngleError, PerComponentCapsule->GetComponentQuat().AngularDistance(BatchedCapsule->GetComponentQuat()));
+		MaxVelocityError = FMath::Max(MaxVelocityError, (PerComponentCapsule->GetPhysicsLinearVelocity() - BatchedCapsule->GetPhysicsLinearVelocity()).GetAbsMax());
+		MinFallingSpeed = FMath::Min(MinFallingSpeed, PerComponentCapsule->GetPhysicsLinearVelocity().Size());
+	}
+
+	// Nothing to compare if the gravity forces were not applied
+	TestTrue(FString::Printf(TEXT("Pawns are falling (min speed %g cm/s)"), MinFallingSpeed), MinFallingSpeed > 1.0f);
+	TestTrue(FString::Printf(TEXT("Capsule rotations match (max error %g rad)"), MaxAngleError), MaxAngleError <= AngleTolerance);
+	TestTrue(FString::Printf(TEXT("Velocities built up by the gravity forces match (max error %g cm/s)"), MaxVelocityError), MaxVelocityError <= VelocityTolerance);
+
+	return true;
+}
+
+/**
+* Batched movement pass math on the game thread vs on the worker threads, at 1k, 10k and 100k pawns, reported in the test log.
+* The parallel results must match the game thread results, and the parallel pass must not be slower at 100k pawns.
+*/
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FCustomGravityMovementBatchThroughputTest, "CustomGravity.Performance.MovementBatchThroughput", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::PerfFilter)
+
+bool FCustomGravityMovementBatchThroughputTest::RunTest(const FString& Parameters)
+{
+	static const int32 NumRuns = 20;
+	const int32 PawnCounts[] = { 1000, 10000, 100000 };
+	const int32 NumWorkerThreads = FTaskGraphInterface::Get().GetNumWorkerThreads();
+
+	FRandomStream RandomStream(1247);
+	FGravityMovementBatch Batch;
+
+	for (const int32 NumPawns : PawnCounts)
+	{
+		Batch.Reset();
+		for (int32 Index = 0; Index < NumPawns; ++Index)
+		{
+			const FQuat Rotation(RandomStream.GetUnitVector(), RandomStream.FRandRange(-PI, PI));
+			const FGravityInfo GravityInfo(RandomStream.FRandRange(500.0f, 2000.0f), RandomStream.GetUnitVector(), EForceMode::EFM_Acceleration, false);
+			const EOrientationInterpolationMode::Type InterpolationMode = (Index % 2) ? EOrientationInterpolationMode::OIM_Slerp : EOrientationInterpolationMode::OIM_RInterpTo;
+
+			Batch.Add(nullptr, nullptr, GravityInfo, RandomStream.GetUnitVector() * 1000.0f, Rotation, Rotation, 1.0f / 60.0f,
+				RandomStream.FRandRange(1.0f, 10.0f), InterpolationMode, 1.0f, RandomStream.FRandRange(0.5f, 2.0f), true);
+		}
+
+		const double SerialTime = CustomGravityBenchmarks::MeasureBestTime(NumRuns, [&]() { Batch.Calculate(false); });
+		const TArray<FQuat> SerialRotations = Batch.NewRotations;
+		const TArray<FVector> SerialForces = Batch.GravityForces;
+
+		const double ParallelTime = CustomGravityBenchmarks::MeasureBestTime(NumRuns, [&]() { Batch.Calculate(true); });
+
+		float MaxAngleError = 0.0f;
+		float MaxForceError = 0.0f;
+		for (int32 Index = 0; Index < NumPawns; ++Index)
+		{
+			MaxAngleError = FMath::Max(MaxAngleError, Batch.NewRotations[Index].AngularDistance(SerialRotations[Index]));
+			MaxForceError = FMath::Max(MaxForceError, (Batch.GravityForces[Index] - SerialForces[Index]).GetAbsMax());
+		}
+
+		AddInfo(FString::Printf(TEXT("Movement batch %6d pawns : serial %8.3f ms | parallel %8.3f ms (%d worker threads) | x%.2f"),
+			NumPawns, SerialTime * 1000.0, ParallelTime * 1000.0, NumWorkerThreads, SerialTime / ParallelTime));
+
+		TestTrue(FString::Printf(TEXT("Parallel rotations match the game thread at %d pawns (max error %g rad)"), NumPawns, MaxAngleError), MaxAngleError <= KINDA_SMALL_NUMBER);
+		TestTrue(FString::Printf(TEXT("Parallel forces match the game thread at %d pawns (max error %g)"), NumPawns, MaxForceError), MaxForceError <= KINDA_SMALL_NUMBER);
+
+		// Only the largest batch is sure to be worth the worker threads
+		if (NumPawns == PawnCounts[ARRAY_COUNT(PawnCounts) - 1] && NumWorkerThreads > 1)
+		{
+			TestTrue(FString::Printf(TEXT("Parallel %.3f ms not slower than game thread %.3f ms at %d pawns"), ParallelTime * 1000.0, SerialTime * 1000.0, NumPawns),
+				ParallelTime <= SerialTime);
+		}
+	}
+
+	return true;
+}
+
+#endif
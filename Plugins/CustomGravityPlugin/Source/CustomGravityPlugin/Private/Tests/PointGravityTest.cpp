@@ -0,0 +1,107 @@
+// Copyright 2015 Elhoussine Mehnik (Mhousse1247). All Rights Reserved.
+//******************* http://ue4resources.com/ *********************//
+
+
+#include "CustomGravityPluginPrivatePCH.h"
+#include "CustomGravityBenchmarks.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace PointGravityTest
+{
+	/** Random locations around PlanetLocation, the last one on the planet location itself. */
+	void MakeLocations(int32 NumLocations, const FVector& PlanetLocation, TArray<FVector>& OutLocations)
+	{
+		FRandomStream RandomStream(1247);
+
+		OutLocations.SetNumUninitialized(NumLocations);
+		for (FVector& Location : OutLocations)
+		{
+			Location = PlanetLocation + RandomStream.GetUnitVector() * RandomStream.FRandRange(1.0f, 50000.0f);
+		}
+		OutLocations.Last() = PlanetLocation;
+	}
+}
+
+/** The SIMD point gravity directions and distances match FVector::GetSafeNormal and FVector::Size, packed and remaining locations included. */
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FCustomGravityPointGravityTest, "CustomGravity.PointGravity.SimdMatchesScalar", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FCustomGravityPointGravityTest::RunTest(const FString& Parameters)
+{
+	// Not a multiple of 4 : the last locations go through the scalar loop
+	static const int32 NumLocations = 1027;
+	const FVector PlanetLocation(100.0f, -250.0f, 30.0f);
+
+	TArray<FVector> Locations;
+	PointGravityTest::MakeLocations(NumLocations, PlanetLocation, Locations);
+
+	TArray<FVector> Directions;
+	TArray<float> Distances;
+	Directions.SetNumUninitialized(NumLocations);
+	Distances.SetNumUninitialized(NumLocations);
+
+	APlanetActor::ComputePointGravityDirections(PlanetLocation, Locations.GetData(), NumLocations, Directions.GetData(), Distances.GetData());
+
+	float MaxDirectionError = 0.0f;
+	float MaxDistanceError = 0.0f;
+	for (int32 Index = 0; Index < NumLocations; ++Index)
+	{
+		const FVector Delta = PlanetLocation - Locations[Index];
+		MaxDirectionError = FMath::Max(MaxDirectionError, (Directions[Index] - Delta.GetSafeNormal()).GetAbsMax());
+		MaxDistanceError = FMath::Max(MaxDistanceError, FMath::Abs(Distances[Index] - Delta.Size()) / FMath::Max(1.0f, Delta.Size()));
+	}
+
+	TestTrue(FString::Printf(TEXT("Directions match the scalar path (max error %g)"), MaxDirectionError), MaxDirectionError <= KINDA_SMALL_NUMBER);
+	TestTrue(FString::Printf(TEXT("Distances match the scalar path (max relative error %g)"), MaxDistanceError), MaxDistanceError <= KINDA_SMALL_NUMBER);
+	TestTrue(TEXT("Zero direction on the planet location"), Directions.Last().IsZero());
+
+	return true;
+}
+
+/**
+* Scalar vs SIMD point gravity throughput at 1k, 10k and 100k bodies, reported in the test log.
+* The SIMD evaluation must not be slower than the scalar loop it replaces.
+*/
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FCustomGravityPointGravityThroughputTest, "CustomGravity.Performance.PointGravityThroughput", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::PerfFilter)
+
+bool FCustomGravityPointGravityThroughputTest::RunTest(const FString& Parameters)
+{
+	static const int32 NumRuns = 20;
+	const int32 BodyCounts[] = { 1000, 10000, 100000 };
+	const FVector PlanetLocation(100.0f, -250.0f, 30.0f);
+
+	TArray<FVector> Locations;
+	TArray<FVector> Directions;
+
+	for (const int32 NumLocations : BodyCounts)
+	{
+		PointGravityTest::MakeLocations(NumLocations, PlanetLocation, Locations);
+		Directions.SetNumUninitialized(NumLocations);
+
+		const double ScalarTime = CustomGravityBenchmarks::MeasureBestTime(NumRuns, [&]()
+		{
+			for (int32 Index = 0; Index < NumLocations; ++Index)
+			{
+				Directions[Index] = (PlanetLocation - Locations[Index]).GetSafeNormal();
+			}
+		});
+
+		const double SimdTime = CustomGravityBenchmarks::MeasureBestTime(NumRuns, [&]()
+		{
+			APlanetActor::ComputePointGravityDirections(PlanetLocation, Locations.GetData(), NumLocations, Directions.GetData());
+		});
+
+		AddInfo(FString::Printf(TEXT("Point gravity %6d bodies : scalar %8.3f ms (%7.1f M bodies/s) | SIMD %8.3f ms (%7.1f M bodies/s) | x%.2f"),
+			NumLocations,
+			ScalarTime * 1000.0, NumLocations / ScalarTime / 1000000.0,
+			SimdTime * 1000.0, NumLocations / SimdTime / 1000000.0,
+			ScalarTime / SimdTime));
+
+		TestTrue(FString::Printf(TEXT("SIMD %.3f ms not slower than scalar %.3f ms at %d bodies"), SimdTime * 1000.0, ScalarTime * 1000.0, NumLocations),
+			SimdTime <= ScalarTime);
+	}
+
+	return true;
+}
+
+#endif
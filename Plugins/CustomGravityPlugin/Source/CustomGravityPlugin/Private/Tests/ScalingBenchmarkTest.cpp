@@ -0,0 +1,80 @@
+// Copyright 2015 Elhoussine Mehnik (Mhousse1247). All Rights Reserved.
+//******************* http://ue4resources.com/ *********************//
+
+
+#include "CustomGravityPluginPrivatePCH.h"
+#include "CustomGravityBenchmarks.h"
+#include "Tests/CustomGravityTestWorld.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+/** Scenario size and per frame budgets of the scaling test. Tune them to the machine gating the regressions. */
+static TAutoConsoleVariable<int32> CVarScalingTestBodies(
+	TEXT("CustomGravity.ScalingTest.Bodies"),
+	1000,
+	TEXT("Number of CustomPhysicsActors and of GravityPawns spawned per gravity type by the CustomGravity.Performance.Scaling test."));
+
+static TAutoConsoleVariable<float> CVarScalingTestFrameBudgetMs(
+	TEXT("CustomGravity.ScalingTest.FrameBudgetMs"),
+	33.3f,
+	TEXT("Average frame time above which the CustomGravity.Performance.Scaling test fails."));
+
+static TAutoConsoleVariable<float> CVarScalingTestPhysicsBudgetMs(
+	TEXT("CustomGravity.ScalingTest.PhysicsBudgetMs"),
+	10.0f,
+	TEXT("Average game thread physics time (start and end physics tick functions) above which the CustomGravity.Performance.Scaling test fails."));
+
+static TAutoConsoleVariable<float> CVarScalingTestPluginTickBudgetMs(
+	TEXT("CustomGravity.ScalingTest.PluginTickBudgetMs"),
+	2.0f,
+	TEXT("Average plugin tick time above which the CustomGravity.Performance.Scaling test fails."));
+
+/**
+* Runs the scaling benchmark for every gravity type in a test world and checks the per frame averages against the budgets above.
+* Headless : UE4Editor <Project> -nullrhi -unattended -ExecCmds="Automation RunTests CustomGravity.Performance; Quit"
+*/
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FCustomGravityScalingTest, "CustomGravity.Performance.Scaling", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::PerfFilter)
+
+bool FCustomGravityScalingTest::RunTest(const FString& Parameters)
+{
+	static const int32 NumFrames = 60;
+	static const float DeltaTime = 1.0f / 60.0f;
+
+	FCustomGravityTestWorld TestWorld;
+
+	const TArray<int32> BodyCounts = { FMath::Max(1, CVarScalingTestBodies.GetValueOnGameThread()) };
+	CustomGravityBenchmarks::StartScalingBenchmark(TestWorld.GetWorld(), BodyCounts, NumFrames, false);
+
+	// Warm up frames included, with room to spare
+	const int32 MaxFrames = (NumFrames + 100) * (EGravityType::EGT_GlobalGravity + 1);
+	for (int32 Frame = 0; Frame < MaxFrames && CustomGravityBenchmarks::IsScalingBenchmarkRunning(); ++Frame)
+	{
+		TestWorld.Tick(DeltaTime);
+	}
+
+	if (CustomGravityBenchmarks::IsScalingBenchmarkRunning())
+	{
+		AddError(FString::Printf(TEXT("Scaling benchmark did not finish in %d frames."), MaxFrames));
+		CustomGravityBenchmarks::StopScalingBenchmark();
+		return false;
+	}
+
+	const TArray<CustomGravityBenchmarks::FScalingResult> Results = CustomGravityBenchmarks::GetScalingBenchmarkResults();
+	TestEqual(TEXT("Scenarios run"), Results.Num(), EGravityType::EGT_GlobalGravity + 1);
+
+	for (const CustomGravityBenchmarks::FScalingResult& Result : Results)
+	{
+		const FString Scenario = FString::Printf(TEXT("%d bodies, %s"), Result.NumBodies, *UCustomGravityManager::Conv_GravityTypeToString(Result.GravityType));
+
+		TestTrue(FString::Printf(TEXT("%s : frame %.3f ms within %.3f ms"), *Scenario, Result.FrameMs, CVarScalingTestFrameBudgetMs.GetValueOnGameThread()),
+			Result.FrameMs <= CVarScalingTestFrameBudgetMs.GetValueOnGameThread());
+		TestTrue(FString::Printf(TEXT("%s : physics %.3f ms within %.3f ms"), *Scenario, Result.PhysicsMs, CVarScalingTestPhysicsBudgetMs.GetValueOnGameThread()),
+			Result.PhysicsMs <= CVarScalingTestPhysicsBudgetMs.GetValueOnGameThread());
+		TestTrue(FString::Printf(TEXT("%s : plugin ticks %.3f ms within %.3f ms"), *Scenario, Result.PluginTickMs, CVarScalingTestPluginTickBudgetMs.GetValueOnGameThread()),
+			Result.PluginTickMs <= CVarScalingTestPluginTickBudgetMs.GetValueOnGameThread());
+	}
+
+	return true;
+}
+
+#endif
@@ -0,0 +1,281 @@
+// Copyright 2015 Elhoussine Mehnik (Mhousse1247). All Rights Reserved.
+//******************* http://ue4resources.com/ *********************//
+
+#pragma once
+
+#include "GameFramework/Info.h"
+#include "CustomGravityManager.h"
+#include "PlanetRegistry.h"
+#include "GravitySignificance.h"
+#include "GravityWorldManager.generated.h"
+
+class UCustomGravityComponent;
+class UGravityMovementComponent;
+class AGravityWorldManager;
+
+/**
+* Contiguous update state of all the Custom Gravity components sharing the same gravity type.
+* Entries are kept packed : removing a component moves the last one into its slot.
+*/
+struct FGravityComponentBatch
+{
+	/** Registered components. */
+	TArray<UCustomGravityComponent*> Components;
+
+	/** Primitive component updated by each registered component. Weak : it can be destroyed before the component. */
+	TArray<TWeakObjectPtr<UPrimitiveComponent>> UpdatedComponents;
+
+	/** Gravity scale of each registered component. */
+	TArray<float> GravityScales;
+
+	/** Significance tier of each registered component, EGS_High until the first ranking. */
+	TArray<TEnumAsByte<EGravitySignificance::Type>> SignificanceTiers;
+
+	/** Point gravity force applied on the last evaluation, applied again by reduced tiers. Zero without planet. */
+	TArray<FVector> LastGravityForces;
+
+	int32 Num() const { return Components.Num(); }
+
+	/** Adds a component at the end of the batch and returns its index. */
+	int32 Add(UCustomGravityComponent* Component, UPrimitiveComponent* UpdatedComponent, float GravityScale);
+
+	/** Removes the component at Index. Returns the component moved into that slot, if any. */
+	UCustomGravityComponent* RemoveAtSwap(int32 Index);
+};
+
+
+/**
+* Structure-of-arrays state of the Gravity Movement components queued for the batched movement pass of a frame.
+* Inputs are gathered by the components ticks, outputs are computed in parallel then applied serially.
+*/
+struct CUSTOMGRAVITYPLUGIN_API FGravityMovementBatch
+{
+	/** Queued components, null if a component was unregistered after it was queued. */
+	TArray<UGravityMovementComponent*> Components;
+
+	/** Planet to evaluate point gravity from, null to keep the gravity in GravityInfos. */
+	TArray<const class APlanetActor*> Planets;
+
+	/** Gravity of each component, replaced by the point gravity of its planet if it has one. */
+	TArray<FGravityInfo> GravityInfos;
+
+	/** Capsule location, rotation and orientation interpolation start. */
+	TArray<FVector> Locations;
+	TArray<FQuat> Rotations;
+	TArray<FQuat> InterpStartRotations;
+
+	/** Orientation settings. */
+	TArray<float> DeltaTimes;
+	TArray<float> InterpSpeeds;
+	TArray<TEnumAsByte<EOrientationInterpolationMode::Type>> InterpolationModes;
+	TArray<float> AlignedAngleCosines;
+
+	/** Gravity scale, and whether the gravity force is applied at all (false for default gravity). */
+	TArray<float> GravityScales;
+	TArray<bool> ApplyGravityFlags;
+
+	/** Outputs. Rotations are only written if RotationChangedFlags is set (capsule not aligned yet). */
+	TArray<bool> RotationChangedFlags;
+	TArray<FQuat> NewRotations;
+	TArray<FVector> GravityForces;
+
+	int32 Num() const { return Components.Num(); }
+
+	/** Empties the batch, keeping its allocations. */
+	void Reset();
+
+	/** Adds an entry and returns its index. Outputs are left uninitialized. */
+	int32 Add(UGravityMovementComponent* Component, const APlanetActor* Planet, const FGravityInfo& GravityInfo, const FVector& Location, const FQuat& Rotation,
+		const FQuat& InterpStartRotation, float DeltaTime, float InterpSpeed, EOrientationInterpolationMode::Type InterpolationMode, float AlignedAngleCos, float GravityScale, bool bApplyGravity);
+
+	/** Computes the outputs of every entry, on the worker threads if bParallel is true. Does not touch the components. */
+	void Calculate(bool bParallel);
+};
+
+
+/** Runs the batched movement pass of a gravity manager once all the registered Gravity Movement components have ticked. */
+struct FGravityMovementBatchTickFunction : public FTickFunction
+{
+	AGravityWorldManager* Target;
+
+	FGravityMovementBatchTickFunction() : Target(nullptr) {}
+
+	// FTickFunction interface
+	virtual void ExecuteTick(float DeltaTime, ELevelTick TickType, ENamedThreads::Type CurrentThread, const FGraphEventRef& MyCompletionGraphEvent) override;
+	virtual FString DiagnosticMessage() override;
+	// End of FTickFunction interface
+};
+
+
+/** Global Custom Gravity of a world. */
+struct FGlobalGravitySnapshot
+{
+	/** Gravity information, the direction is normalized. */
+	FGravityInfo GravityInfo;
+
+	/** GravityInfo direction multiplied by its power (before gravity scale). */
+	FVector GravityForce;
+
+	/** Incremented every time the global gravity changes, starts at 1. */
+	int32 Version;
+
+	FGlobalGravitySnapshot()
+		: GravityForce(GravityInfo.GravityDirection * GravityInfo.GravityPower)
+		, Version(1)
+	{
+	}
+};
+
+
+/**
+* One per game world, spawned on demand.
+* Updates every registered Custom Gravity component from a single tick instead of one tick per component.
+*/
+UCLASS(NotPlaceable, Transient)
+class CUSTOMGRAVITYPLUGIN_API AGravityWorldManager : public AInfo
+{
+	GENERATED_BODY()
+
+public:
+
+	/**
+	* Default UObject constructor.
+	*/
+	AGravityWorldManager(const FObjectInitializer& ObjectInitializer);
+
+	// AActor interface
+	virtual void Tick(float DeltaSeconds) override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+	virtual void RegisterActorTickFunctions(bool bRegister) override;
+	// End of AActor interface
+
+	/** Returns the gravity manager of the world WorldContextObject belongs to, spawning it if needed (game worlds only). */
+	static AGravityWorldManager* Get(const UObject* WorldContextObject);
+
+	/** Returns the gravity manager of the world WorldContextObject belongs to, null if it was not spawned. */
+	static AGravityWorldManager* Find(const UObject* WorldContextObject);
+
+	/** Starts updating Component from the batched gravity pass. */
+	void RegisterGravityComponent(UCustomGravityComponent* Component);
+
+	/** Stops updating Component from the batched gravity pass. */
+	void UnregisterGravityComponent(UCustomGravityComponent* Component);
+
+	/** Refreshes the cached state of Component (gravity type, scale, updated component). */
+	void RefreshGravityComponent(UCustomGravityComponent* Component);
+
+	/** Returns the number of components updated by the batched gravity pass. */
+	int32 GetNumGravityComponents() const;
+
+	/**
+	* Wakes the bodies of the Custom Gravity components attracted by Planet, or using the Global Custom Gravity if Planet is null.
+	* Batched or not : bodies skipping gravity while sleeping would not notice the change otherwise.
+	*/
+	void WakeGravityComponents(const class APlanetActor* Planet);
+
+	/** Makes Component queue its orientation and gravity in the batched movement pass, which ticks after it and before its pawn mesh. */
+	void RegisterMovementComponent(UGravityMovementComponent* Component);
+
+	/** Stops batching the movement of Component. */
+	void UnregisterMovementComponent(UGravityMovementComponent* Component);
+
+	/**
+	* Queues this frame's orientation and gravity update of Component.
+	* Planet, if not null, is the planet its point gravity is evaluated from. Without gravity, only the capsule is oriented.
+	*/
+	void QueueMovementUpdate(UGravityMovementComponent* Component, float DeltaTime, float InterpSpeed, const APlanetActor* Planet, bool bApplyGravity);
+
+	/** Returns the number of Gravity Movement components using the batched movement pass. */
+	int32 GetNumMovementComponents() const { return MovementComponents.Num(); }
+
+	/** Returns the Global Custom Gravity of this world, including changes not published yet. Game thread only. */
+	const FGravityInfo& GetGlobalGravityInfo() const { return PendingGlobalGravity.GravityInfo; }
+
+	/** Returns the version of GetGlobalGravityInfo(). Game thread only. */
+	int32 GetGlobalGravityVersion() const { return PendingGlobalGravity.Version; }
+
+	/** Changes the Global Custom Gravity of this world. Published at the start of the next manager tick. */
+	void SetGlobalGravityInfo(const FGravityInfo& NewGravityInfo);
+
+	/**
+	* Returns the Global Custom Gravity published for the current frame.
+	* Can be read from any thread, the returned snapshot is not modified before the next frame publishes a new one.
+	*/
+	const FGlobalGravitySnapshot& GetGlobalGravitySnapshot() const { return GlobalGravitySnapshots[PublishedGlobalGravityIndex.GetValue()]; }
+
+	/** Called on the game thread when a new Global Custom Gravity is published. */
+	FOnGlobalCustomGravityChanged OnGlobalGravityChanged;
+
+	/** Called on the game thread when a new Global Custom Gravity is published. */
+	UPROPERTY(BlueprintAssignable, Category = "Global Custom Gravity")
+		FOnGlobalCustomGravityChangedDynamic OnGlobalGravityChangedEvent;
+
+	/** Returns the registry of the planets of this world, used for automatic planet selection. */
+	FPlanetRegistry& GetPlanetRegistry() { return PlanetRegistry; }
+
+	/** Returns the significance manager of this world, ranking gravity pawns and gravity bodies (CustomGravity.Significance). */
+	FGravitySignificanceManager& GetSignificanceManager() { return SignificanceManager; }
+
+protected:
+
+	/** Batched update of all the registered Custom Gravity components. */
+	virtual void UpdateGravityComponents(float DeltaTime);
+
+	/** Batched movement pass : computes the queued movement updates in parallel, then writes them to the components. */
+	virtual void UpdateMovementBatch(float DeltaTime);
+
+	/** Ranks the registered Custom Gravity components again. With bDrawOnly, only draws their current tiers. */
+	void UpdateGravityComponentsSignificance(bool bDrawOnly);
+
+private:
+
+	void UpdateDefaultGravityBatch(FGravityComponentBatch& Batch);
+	void UpdateCustomGravityBatch(FGravityComponentBatch& Batch);
+	void UpdateGlobalGravityBatch(FGravityComponentBatch& Batch);
+	void UpdatePointGravityBatch(FGravityComponentBatch& Batch);
+
+	/** Planets of this world. */
+	FPlanetRegistry PlanetRegistry;
+
+	/** Significance tiers of the gravity pawns, and of the gravity components through GravityBatches. */
+	FGravitySignificanceManager SignificanceManager;
+
+	/** Registered components, one batch per gravity type. */
+	FGravityComponentBatch GravityBatches[EGravityType::EGT_GlobalGravity + 1];
+
+	/** Copies the pending Global Custom Gravity to the back snapshot and makes it the published one. */
+	void PublishGlobalGravity();
+
+	/** Global Custom Gravity as set on the game thread. */
+	FGlobalGravitySnapshot PendingGlobalGravity;
+
+	/** Published and back Global Custom Gravity snapshots. */
+	FGlobalGravitySnapshot GlobalGravitySnapshots[2];
+
+	/** Index of the published snapshot in GlobalGravitySnapshots. */
+	FThreadSafeCounter PublishedGlobalGravityIndex;
+
+	friend struct FGravityMovementBatchTickFunction;
+
+	/** Gravity Movement components using the batched movement pass. */
+	TArray<UGravityMovementComponent*> MovementComponents;
+
+	/** Movement updates queued this frame. */
+	FGravityMovementBatch MovementBatch;
+
+	/** Tick of the batched movement pass, prerequisites are the ticks of MovementComponents. Prerequisite of their pawn meshes. */
+	FGravityMovementBatchTickFunction MovementBatchTickFunction;
+
+	/** Returns the ticking mesh of the Gravity Pawn owning Component, which has to tick after the batched movement pass. */
+	static USkeletalMeshComponent* GetBatchedPawnMesh(const UGravityMovementComponent* Component);
+
+	/** Point gravity scratch buffers, reused every frame. Bodies are grouped by planet. */
+	TArray<class APlanetActor*> PointGravityPlanets;
+	TArray<int32> PointGravityPlanetOffsets;
+	TArray<int32> PointGravityPlanetSlots;
+	TArray<FVector> PointGravityBodyLocations;
+	TArray<int32> PointGravitySortedIndices;
+	TArray<FVector> PointGravityLocations;
+	TArray<FVector> PointGravityDirections;
+	TArray<float> PointGravityPowers;
+};
@@ -7,6 +7,8 @@
 #include "CustomGravityManager.h"
 #include "PlanetActor.generated.h"
 
+class UGravityFieldAsset;
+
 UENUM(BlueprintType)
 enum class ECollisionType : uint8
 {
@@ -14,6 +16,34 @@ enum class ECollisionType : uint8
 	ECol_Sphere 	UMETA(DisplayName = "Sphere Collision")
 };
 
+/** How the planet gravity power decreases with the distance to the planet center. */
+UENUM(BlueprintType)
+enum class EGravityFalloff : uint8
+{
+	EGF_Constant 	UMETA(DisplayName = "Constant"),
+	EGF_InverseSquare 	UMETA(DisplayName = "Inverse Square"),
+	EGF_Linear 	UMETA(DisplayName = "Linear"),
+	EGF_Curve 	UMETA(DisplayName = "Curve")
+};
+
+
+/** Gravity power multipliers, sampled uniformly from the planet center to the falloff radius. Never modified once built. */
+struct FGravityFalloffTable
+{
+	TArray<float> Multipliers;
+
+	/** Number of samples per distance unit. */
+	float Scale;
+
+	FGravityFalloffTable() : Scale(0.0f) {}
+
+	/** Multiplier at Distance from the planet center, 0 beyond the falloff radius. */
+	float GetMultiplier(float Distance) const;
+};
+
+/** Rebuilding the falloff replaces the table, readers on other threads keep the one they captured. */
+typedef TSharedPtr<const FGravityFalloffTable, ESPMode::ThreadSafe> FGravityFalloffTablePtr;
+
 
 UCLASS()
 class  CUSTOMGRAVITYPLUGIN_API APlanetActor : public AActor
@@ -31,6 +61,8 @@ public:
 	
 // AActor interface
 	virtual void PostInitializeComponents() override;
+	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 #if WITH_EDITOR
 	virtual void PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent);
 #endif // WITH_EDITOR
@@ -78,6 +110,45 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Planet Actor : General Settings")
 		bool bShouldUseStepping = true;
 
+	/** Gravity falloff model :
+	* - Constant : GravityPower at any distance.
+	* - Inverse Square : GravityPower * (FalloffStartDistance / Distance)^2, FalloffStartDistance being at least the sphere collision radius.
+	* - Linear : from GravityPower at FalloffStartDistance to 0 at FalloffRadius.
+	* - Curve : GravityPower * FalloffCurve, curve time goes from 0 at FalloffStartDistance to 1 at FalloffRadius.
+	* Gravity is GravityPower closer than FalloffStartDistance, and 0 beyond FalloffRadius (except Constant).
+	*/
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Planet Actor : Gravity Falloff")
+		EGravityFalloff GravityFalloff;
+
+	/** Distance from the planet center where the falloff starts (usually the planet surface). */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Planet Actor : Gravity Falloff", meta = (ClampMin = "0", UIMin = "0"))
+		float FalloffStartDistance;
+
+	/** Distance from the planet center beyond which there is no gravity. */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Planet Actor : Gravity Falloff", meta = (ClampMin = "0", UIMin = "0"))
+		float FalloffRadius;
+
+	/** Gravity power multiplier, used when GravityFalloff is set to "Curve". */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Planet Actor : Gravity Falloff")
+		class UCurveFloat* FalloffCurve;
+
+	/** Number of samples of the falloff lookup table. */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Planet Actor : Gravity Falloff", AdvancedDisplay, meta = (ClampMin = "2", UIMin = "2", UIMax = "4096"))
+		int32 FalloffTableResolution;
+
+	/** Baked gravity directions around the planet mesh, used when CollisionType is set to "Mesh Collision".
+	* Outside the baked bricks, or until the bricks are read (started on BeginPlay), gravity points to the planet center.
+	*/
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Planet Actor : Gravity Field")
+		UGravityFieldAsset* GravityField;
+
+	/** Sphere of influence radius.
+	* Point gravity bodies without a planet reference are attracted by the planet with the strongest influence at their location.
+	* 0 = the planet is never selected automatically.
+	*/
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Planet Actor : General Settings", meta = (ClampMin = "0", UIMin = "0"))
+		float SphereOfInfluenceRadius;
+
 	/**Change planet gravity power. */
 	UFUNCTION(BlueprintCallable, Category = "PlanetActor")
 		void SetGravityPower(float NewGravity);
@@ -96,6 +167,60 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "PlanetActor")
 		FGravityInfo GetGravityinfo(const FVector& TargetLocation) const;
 
+	/** Rebuilds the falloff lookup table. Needed after changing falloff settings at runtime. */
+	UFUNCTION(BlueprintCallable, Category = "PlanetActor")
+		void RebuildFalloffTable();
+
+	/** Returns the gravity power at Distance from the planet center, falloff included. */
+	UFUNCTION(BlueprintCallable, Category = "PlanetActor")
+		float GetGravityPowerAtDistance(float Distance) const;
+
+	/** Bakes the planet mesh collision into GravityField. Editor only, needs a mesh with simple collision. */
+	UFUNCTION(CallInEditor, Category = "Planet Actor : Gravity Field")
+		void BakeGravityField();
+
+	/**
+	* Gravity direction and power at TargetLocation for a planet placed at PlanetTransform, from explicit planet state.
+	* InFalloffTable is null for constant gravity, InGravityField null if the planet does not use a loaded gravity field.
+	* Does not read any actor : can be called from physics substeps with a state captured on the game thread.
+	*/
+	static void EvaluateGravity(const FTransform& PlanetTransform, float InGravityPower, const FGravityFalloffTable* InFalloffTable, const UGravityFieldAsset* InGravityField,
+		const FVector& TargetLocation, FVector& OutGravityDirection, float& OutGravityPower);
+
+	/** Returns the current falloff table, null for constant gravity. */
+	const FGravityFalloffTablePtr& GetFalloffTable() const { return FalloffTable; }
+
+	/** Wakes the sleeping bodies attracted by this planet, after a gravity change. */
+	void WakeAttractedBodies();
+
+	/** Returns true if gravity directions are read from the baked gravity field : false until its asynchronous read completes. */
+	bool UsesGravityField() const;
+
+	/** Change the sphere of influence radius. */
+	UFUNCTION(BlueprintCallable, Category = "PlanetActor")
+		void SetSphereOfInfluenceRadius(float NewRadius);
+
+	/**
+	* Returns how strongly the planet attracts TargetLocation, used to select the dominant planet.
+	* 0 outside the sphere of influence (scaled by RadiusScale), GravityPower at the planet center.
+	*/
+	float GetInfluence(const FVector& TargetLocation, float RadiusScale = 1.0f) const;
+
+	/**
+	* Batched version of GetGravityinfo.
+	* Writes the gravity direction and power for each target location, output arrays are resized to TargetLocations.Num().
+	*/
+	void GetGravityInfoBatch(const TArray<FVector>& TargetLocations, TArray<FVector>& OutGravityDirections, TArray<float>& OutGravityPowers) const;
+
+	/** Batched version of GetGravityinfo. Output arrays must hold NumLocations elements. */
+	void GetGravityInfoBatch(const FVector* TargetLocations, int32 NumLocations, FVector* OutGravityDirections, float* OutGravityPowers) const;
+
+	/**
+	* Point gravity directions (normalized PlanetLocation - TargetLocation) for a contiguous array of locations.
+	* Uses SIMD vector registers, 4 locations per iteration.
+	*/
+	static void ComputePointGravityDirections(const FVector& PlanetLocation, const FVector* TargetLocations, int32 NumLocations, FVector* OutGravityDirections, float* OutDistances = nullptr);
+
 
 
 private:
@@ -119,6 +244,20 @@ protected:
 
 	virtual void Initialization();
 
+	/** Samples the falloff model over [0, FalloffRadius]. */
+	void BuildFalloffTable();
+
+	/** Smallest Inverse Square start distance : the sphere collision radius, at least 1 unit, so the falloff never drops to 0 at the start. */
+	float GetMinInverseSquareStartDistance() const;
+
+private:
+
+	/** Gravity power multipliers, sampled uniformly from the planet center to FalloffRadius. Null for constant gravity. */
+	FGravityFalloffTablePtr FalloffTable;
+
+	/** If true, the falloff table is rebuilt by the next Initialization(). */
+	bool bFalloffTableDirty;
+
 public:
 	/** Returns Ball subobject **/
 	FORCEINLINE class UStaticMeshComponent* GetPlanetMesh() const { return MeshComponent; }
@@ -127,3 +266,36 @@ public:
 	/** Returns SphereCollision subobject **/
 	FORCEINLINE class USphereComponent* GetSphereCollision() const { return SphereCollision; }
 };
+
+
+/**
+* Point gravity of a planet captured on the game thread, evaluated at the body location of each physics substep.
+* Used with FBodyInstance::AddCustomPhysics.
+*/
+struct CUSTOMGRAVITYPLUGIN_API FSubstepPointGravity
+{
+	/** True if a planet was captured, false if there is nothing to apply. */
+	bool bHasPlanet;
+
+	/** Planet transform, gravity power and force mode for this frame. */
+	FTransform PlanetTransform;
+	float GravityPower;
+	TEnumAsByte<EForceMode::Type> ForceMode;
+
+	/** Falloff table of the planet for this frame, null for constant gravity. */
+	FGravityFalloffTablePtr FalloffTable;
+
+	/** Loaded gravity field of the planet, null if it does not use one. Loaded fields are not modified. */
+	const UGravityFieldAsset* GravityField;
+
+	/** Gravity scale of the attracted body. */
+	float GravityScale;
+
+	FSubstepPointGravity();
+
+	/** Copies the planet state for the coming physics step : Apply() does not read the planet. Game thread only. */
+	void Capture(const APlanetActor* NewPlanet, float NewGravityScale);
+
+	/** Adds the gravity at the current substep location of BodyInstance. Called from the custom physics callback. */
+	void Apply(FBodyInstance* BodyInstance) const;
+};
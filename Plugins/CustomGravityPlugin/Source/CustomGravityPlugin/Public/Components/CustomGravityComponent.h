@@ -1,5 +1,6 @@
 #pragma once
 #include "CustomGravityManager.h"
+#include "PlanetActor.h"
 #include "CustomGravityComponent.generated.h"
 
 
@@ -16,7 +17,9 @@ public:
 
 	//Begin UActorComponent Interface
 	virtual void InitializeComponent() override;
+	virtual void UninitializeComponent() override;
 	virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+	virtual void SetComponentTickEnabled(bool bEnabled) override;
 	//End UActorComponent Interface
 
 	/**Change Gravity Scale*/
@@ -27,6 +30,10 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "Physics|Components|CustomGravity")
 		void SetGravityType(EGravityType::Type NewGravityType);
 
+	/** Enable or disable skipping gravity for sleeping bodies. */
+	UFUNCTION(BlueprintCallable, Category = "Physics|Components|CustomGravity")
+		void SetSkipGravityWhileSleeping(bool bNewSkipGravityWhileSleeping);
+
 	/**Update Current Planet Reference*/
 	UFUNCTION(BlueprintCallable, Category = "Physics|Components|CustomGravity")
 		void SetCurrentPlanet(class APlanetActor* NewPlanet);
@@ -43,7 +50,7 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "Physics|Components|CustomGravity")
 		UPrimitiveComponent* GetUpdatedComponent() const;
 
-	/** Return APlanetActor reference. */
+	/** Return APlanetActor reference, or the automatically selected planet if the reference is null. */
 	UFUNCTION(BlueprintCallable, Category = "Physics|Components|CustomGravity")
 		class APlanetActor* GetCurrentPlanet() const;
 
@@ -61,6 +68,10 @@ public:
 
 protected:
 
+	//Begin UActorComponent Interface
+	virtual void RegisterComponentTickFunctions(bool bRegister) override;
+	//End UActorComponent Interface
+
 	/** Custom Gravity scale. Gravity is multiplied by this amount for the component owner. */
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, meta = (AllowPrivateAccess = "true"), Category = "Custom Gravity Component (General Settings)")
 		float GravityScale;
@@ -83,10 +94,29 @@ protected:
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, meta = (AllowPrivateAccess = "true"), Category = "Custom Gravity Component (General Settings)")
 		TEnumAsByte<EGravityType::Type> GravityType;
 
-	/**Planet Actor Reference .*/
+	/**Planet Actor Reference .
+	* If null , Point Gravity uses the planet with the strongest influence at the component location.
+	*/
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, meta = (AllowPrivateAccess = "true"), Category = "Custom Gravity Component (General Settings)")
 		class APlanetActor* PlanetActor;
 
+	/** When the planet is selected automatically, how much stronger (ratio) another planet must be to take over. */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, meta = (AllowPrivateAccess = "true", ClampMin = "0", UIMin = "0"), Category = "Custom Gravity Component (General Settings)")
+		float PlanetSelectionHysteresis;
+
+	/** If true, Point Gravity is evaluated in every physics substep at the body location of that substep, instead of once per frame.
+	* Gives correct orbits at low frame rates. bSkipGravityWhileSleeping is ignored in this mode.
+	*/
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, meta = (AllowPrivateAccess = "true"), Category = "Custom Gravity Component (General Settings)")
+		bool bApplyGravityInSubsteps;
+
+	/** If true, gravity is not applied to a sleeping body while its gravity force does not change, so resting bodies stay asleep.
+	* While the force does not change and the body moves slower than its sleep threshold, gravity is applied without keeping it awake.
+	* A gravity change (power, direction, scale, type, global gravity, planet gravity) wakes the body up.
+	*/
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, meta = (AllowPrivateAccess = "true"), Category = "Custom Gravity Component (General Settings)")
+		bool bSkipGravityWhileSleeping;
+
 
 	/**The Updated Collision Component*/
 	UPrimitiveComponent* UpdatedComponent;
@@ -94,5 +124,77 @@ protected:
 	/**Current Gravity Information : Updated each frame.*/
 	FGravityInfo CurrentGravityInfo;
 
+	/** Returns the Planet Actor reference if set, otherwise the dominant planet at Location. */
+	class APlanetActor* ResolvePlanet(const FVector& Location);
+
+	/** Updates CurrentGravityInfo and applies gravity to UpdatedComponent (per-component tick path). */
+	virtual void UpdateGravity();
+
+	/** Default gravity : lets the physics engine apply the physics volume gravity. */
+	void UpdateDefaultGravity();
+
+	/** Applies GravityForce to UpdatedComponent, unless the body sleeps and gravity did not change (bSkipGravityWhileSleeping). */
+	void ApplyGravity(const FVector& GravityForce, const FGravityInfo& GravityInfo);
+
+	/** Captures Planet and queues the substep gravity callback of UpdatedComponent for the coming physics step. */
+	void QueueSubstepGravity(class APlanetActor* Planet);
+
+	/** Custom physics callback : applies SubstepGravity for one substep. */
+	void CalculateSubstepGravity(float DeltaTime, FBodyInstance* BodyInstance);
+
+	/** Wakes UpdatedComponent up and forgets the last applied gravity force. */
+	void WakeUpdatedComponent();
+
+	/** Queues GravityForce for the coming physics step, applied without resetting the sleep timer of a body at rest. */
+	void QueueRestingGravity(const FVector& GravityForce, const FGravityInfo& GravityInfo);
+
+	/** Custom physics callback : adds RestingGravityForce, waking the body only if it moves faster than its sleep threshold. */
+	void ApplyRestingGravity(float DeltaTime, FBodyInstance* BodyInstance);
+
+	/** Applies GravityForce to Body using GravityInfo force mode & sub-stepping. */
+	static void ApplyGravityForce(UPrimitiveComponent* Body, const FVector& GravityForce, const FGravityInfo& GravityInfo);
+
+private:
+
+	friend class AGravityWorldManager;
+
+	/** Gravity manager of the world : updates this component (unless it ticks on its own) and selects its planet. */
+	TWeakObjectPtr<class AGravityWorldManager> GravityManager;
+
+	/** Planet selected automatically when Point Gravity is used without a Planet Actor reference. */
+	TWeakObjectPtr<class APlanetActor> AutoSelectedPlanet;
+
+	/** Index of this component in its gravity manager batch, INDEX_NONE if the component ticks on its own or is not ticking. */
+	int32 GravityBatchIndex;
+
+	/**
+	* True if the component is updated by the gravity manager batch instead of its own tick (CustomGravity.BatchedUpdate).
+	* Its tick function stays disabled : enabling or disabling its tick (Activate, Deactivate) adds it to or removes it from the batch.
+	*/
+	bool bUseGravityBatch;
+
+	/** Gravity type of the gravity manager batch this component belongs to. */
+	TEnumAsByte<EGravityType::Type> BatchedGravityType;
+
+	/** Gravity force applied on the last update, used to detect gravity changes of sleeping bodies. */
+	FVector LastGravityForce;
+
+	/** Unchanged gravity force applied to a body at rest (bSkipGravityWhileSleeping). */
+	FVector RestingGravityForce;
+	bool bRestingGravityAccelChange;
+	FCalculateCustomPhysics OnApplyRestingGravity;
+
+	/** Point gravity evaluated in the physics substeps (bApplyGravityInSubsteps). */
+	FSubstepPointGravity SubstepGravity;
+	FCalculateCustomPhysics OnCalculateSubstepGravity;
+
+	/** Global Custom Gravity version CurrentGravityInfo and GlobalGravityForce were computed at, 0 if they do not hold the global gravity. */
+	int32 GlobalGravityVersion;
+
+	/** Global Custom Gravity force scaled by GravityScale, per-component tick path only. */
+	FVector GlobalGravityForce;
+
+	/** True if LastGravityForce was applied to the current UpdatedComponent. */
+	bool bHasLastGravityForce;
 
 };
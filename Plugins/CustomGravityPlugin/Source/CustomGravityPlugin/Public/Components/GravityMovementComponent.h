@@ -2,6 +2,9 @@
 #pragma once
 #include "Kismet/KismetSystemLibrary.h"
 #include "CustomGravityManager.h"
+#include "PlanetActor.h"
+#include "GravityTrajectory.h"
+#include "GravitySignificance.h"
 #include "GravityMovementComponent.generated.h"
 
 
@@ -18,6 +21,7 @@ public:
 
 	//Begin UActorComponent Interface
 	virtual void InitializeComponent() override;
+	virtual void UninitializeComponent() override;
 	virtual void TickComponent(float DeltaTime, enum ELevelTick TickType, FActorComponentTickFunction *ThisTickFunction) override;
 	//End UActorComponent Interface
 
@@ -43,6 +47,35 @@ public:
 	virtual void EnableDebuging();
 	virtual void DisableDebuging();
 
+	/**
+	* Resets gravity, orientation, ground and jump state to their initial values, as after InitializeComponent.
+	* Does not stop the capsule : call StopMovementImmediately() as well to move it again from rest, e.g. after a teleport.
+	*/
+	virtual void ResetMovementState();
+
+	/**
+	* Rotation of a capsule at CapsuleRotation after one orientation step toward TargetUpVector, interpolated from InterpStartRotation.
+	* Returns false, with OutRotation set to CapsuleRotation, if the cosine of the angle between the capsule up vector
+	* and TargetUpVector is at least AlignedAngleCos : the capsule is already aligned.
+	* A RotationSpeed of 0 or less snaps to the target rotation.
+	* Pure function, safe on any thread.
+	*/
+	static bool CalcCapsuleRotation(const FQuat& CapsuleRotation, const FQuat& InterpStartRotation, const FVector& TargetUpVector,
+		float DeltaTime, float RotationSpeed, EOrientationInterpolationMode::Type InterpolationMode, float AlignedAngleCos, FQuat& OutRotation);
+
+	/** Gravity force of GravityInfo scaled by GravityScale. Pure function, safe on any thread. */
+	static FVector CalcGravityForce(const FGravityInfo& GravityInfo, float GravityScale);
+
+	/**
+	* Sets the significance tier of the owner (CustomGravity.Significance).
+	* Below EGS_High the capsule snaps to its gravity instead of interpolating, and the ground is probed with line traces,
+	* only every few frames at EGS_Low. Multi hit and asynchronous ground probes are not affected.
+	*/
+	void SetSignificance(EGravitySignificance::Type NewSignificance) { Significance = NewSignificance; }
+
+	/** Returns the significance tier of the owner. */
+	EGravitySignificance::Type GetSignificance() const { return Significance; }
+
 
 	UCharacterMovementComponent*  a;
 
@@ -65,6 +98,18 @@ public:
 	UPROPERTY(Category = "Gravity Movement Component : General Settings", EditAnywhere, BlueprintReadWrite)
 		float JumpDistance = 300.f;
 
+	/** Integration time step (in seconds) of jump predictions. */
+	UPROPERTY(Category = "Gravity Movement Component : Jump Prediction", EditAnywhere, BlueprintReadWrite, AdvancedDisplay, meta = (ClampMin = "0.001", UIMin = "0.001"))
+		float JumpPredictionTimeStep;
+
+	/** Maximum number of integration steps of a jump prediction. Paths not landing within them are reported as not landing. */
+	UPROPERTY(Category = "Gravity Movement Component : Jump Prediction", EditAnywhere, BlueprintReadWrite, AdvancedDisplay, meta = (ClampMin = "1", UIMin = "1"))
+		int32 JumpPredictionMaxSteps;
+
+	/** Number of integration steps covered by one sweep of a jump prediction. Higher is cheaper but may cut corners. */
+	UPROPERTY(Category = "Gravity Movement Component : Jump Prediction", EditAnywhere, BlueprintReadWrite, AdvancedDisplay, meta = (ClampMin = "1", UIMin = "1"))
+		int32 JumpPredictionSweepStride;
+
 	/** Maximum acceptable distance for Gravity pawn capsule/sphere to walk above a surface. */
 	UPROPERTY(Category = "Gravity Movement Component : General Settings", EditAnywhere, BlueprintReadWrite, meta = (ClampMin = "0", UIMin = "0"))
 		float GroundHitToleranceDistance;
@@ -88,6 +133,28 @@ public:
 	UPROPERTY(Category = "Gravity Movement Component : General Settings", EditAnywhere, BlueprintReadWrite)
 		bool bResetVelocityOnGravitySwitch;
 
+	/**
+	* If true, ground and surface traces are issued asynchronously : the result of a query is used one frame after it was issued.
+	* Box surface traces stay synchronous.
+	*/
+	UPROPERTY(Category = "Gravity Movement Component : General Settings", EditAnywhere, BlueprintReadWrite, AdvancedDisplay)
+		bool bUseAsyncGroundQueries;
+
+	/** If true, the locally controlled pawn keeps synchronous ground and surface traces when async ground queries are used. */
+	UPROPERTY(Category = "Gravity Movement Component : General Settings", EditAnywhere, BlueprintReadWrite, AdvancedDisplay, meta = (editcondition = "bUseAsyncGroundQueries"))
+		bool bSyncGroundQueriesForLocalPlayer;
+
+	/**
+	* If true, a recent floor contact of the capsule is trusted as the ground instead of sweeping for it.
+	* The ground is swept again once floor contacts stop arriving or the pawn jumps. Not used with Ground Probe Multi Hit.
+	*/
+	UPROPERTY(Category = "Gravity Movement Component : General Settings", EditAnywhere, BlueprintReadWrite, AdvancedDisplay)
+		bool bUseContactGroundCache;
+
+	/** How long (in seconds) a floor contact is trusted as the ground. */
+	UPROPERTY(Category = "Gravity Movement Component : General Settings", EditAnywhere, BlueprintReadWrite, AdvancedDisplay, meta = (ClampMin = "0", UIMin = "0", editcondition = "bUseContactGroundCache"))
+		float ContactGroundCacheTime;
+
 	/**Determine pawn's vertical orientation when is moving on ground*/
 	UPROPERTY(Category = "Gravity Movement Component : General Settings", EditAnywhere, BlueprintReadWrite)
 		TEnumAsByte<EVerticalOrientation::Type> StandingVerticalOrientation;
@@ -104,6 +171,25 @@ public:
 	UPROPERTY(Category = "Gravity Movement Component : General Settings", EditAnywhere, BlueprintReadWrite)
 		FOrientationSettings OrientationSettings;
 
+	/** The capsule is not rotated while the angle (in degrees) between its up vector and the wanted up vector is below this value. */
+	UPROPERTY(Category = "Gravity Movement Component : General Settings", EditAnywhere, BlueprintReadWrite, AdvancedDisplay, meta = (ClampMin = "0", ClampMax = "10", UIMin = "0", UIMax = "10"))
+		float OrientationAngleTolerance;
+
+	/**
+	* If true, gravity, orientation, ground and jump state advance in fixed steps of Fixed Time Step seconds, whatever the frame rate.
+	* The capsule keeps the rotation of the last step, the pawn mesh shows it interpolated between the last two steps. Not used with CustomGravity.BatchedMovementUpdate.
+	*/
+	UPROPERTY(Category = "Gravity Movement Component : General Settings", EditAnywhere, BlueprintReadWrite, AdvancedDisplay)
+		bool bUseFixedTimeStep;
+
+	/** Duration of a simulation step when Use Fixed Time Step is enabled (1/30 : 30 Hz). */
+	UPROPERTY(Category = "Gravity Movement Component : General Settings", EditAnywhere, BlueprintReadWrite, AdvancedDisplay, meta = (ClampMin = "0.001", UIMin = "0.001", editcondition = "bUseFixedTimeStep"))
+		float FixedTimeStep;
+
+	/** Maximum number of simulation steps per frame, the remaining time is dropped after a hitch. */
+	UPROPERTY(Category = "Gravity Movement Component : General Settings", EditAnywhere, BlueprintReadWrite, AdvancedDisplay, meta = (ClampMin = "1", UIMin = "1", editcondition = "bUseFixedTimeStep"))
+		int32 MaxFixedStepsPerFrame;
+
 	/**Traces Debug Draw Type*/
 	UPROPERTY(Category = "Gravity Movement Component : General Settings", EditAnywhere, BlueprintReadWrite)
 		TEnumAsByte<EDrawDebugTrace::Type> DebugDrawType;
@@ -119,12 +205,21 @@ public:
 		FGravityInfo CustomGravityInfo;
 
 	/**Planet Actor Reference .
-	* Needed when "Custom Gravity Type" is set to "Point Gravity"
-	* If "Point Gravity" is selected and "Planet Actor" is null , No gravity will be applied.
+	* Used when "Custom Gravity Type" is set to "Point Gravity"
+	* If "Point Gravity" is selected and "Planet Actor" is null , the planet with the strongest influence at the pawn location is used.
+	* If there is no such planet , No gravity will be applied.
 	*/
 	UPROPERTY(Category = "Gravity Movement Component : Custom Gravity", EditAnywhere, BlueprintReadWrite)
 		APlanetActor* PlanetActor;
 
+	/** When the planet is selected automatically, how much stronger (ratio) another planet must be to take over. */
+	UPROPERTY(Category = "Gravity Movement Component : Custom Gravity", EditAnywhere, BlueprintReadWrite, meta = (ClampMin = "0", UIMin = "0"))
+		float PlanetSelectionHysteresis;
+
+	/** If true, Point Gravity is evaluated in every physics substep at the capsule location of that substep, instead of once per frame. */
+	UPROPERTY(Category = "Gravity Movement Component : Custom Gravity", EditAnywhere, BlueprintReadWrite)
+		bool bApplyGravityInSubsteps;
+
 	/** Surface Based Gravity Information , if Vertical Orientation is set to "Surface Normal".*/
 	UPROPERTY(Category = "Gravity Movement Component : Surface Based Gravity", EditAnywhere, BlueprintReadWrite)
 		FGravityInfo SurfaceBasedGravityInfo;
@@ -133,6 +228,17 @@ public:
 	UPROPERTY(Category = "Gravity Movement Component : Surface Based Gravity", EditAnywhere, BlueprintReadWrite)
 		bool bUseCapsuleHit;
 	/**
+	* If enabled, the standing/falling sweep also provides the surface normal : one query per frame instead of two.
+	* Trace Shape and Trace Shape Scale are not used.
+	*/
+	UPROPERTY(Category = "Gravity Movement Component : Surface Based Gravity", EditAnywhere, BlueprintReadWrite, meta = (editcondition = "!bUseCapsuleHit"))
+		bool bUseGroundProbeForSurface;
+
+	/** If enabled, the standing/falling sweep returns every hit along the probe in GroundProbeHits instead of the first blocking hit only. */
+	UPROPERTY(Category = "Gravity Movement Component : Surface Based Gravity", EditAnywhere, BlueprintReadWrite)
+		bool bGroundProbeMultiHit;
+
+	/**
 	* Editable if UseCapsuleHit is set to true .
 	* Trace shape used to test the surface the Gravity pawn is standing on .
 	*/
@@ -170,10 +276,21 @@ public:
 	UPROPERTY(Category = "Gravity Movement Component : Physics Interaction", EditAnywhere, BlueprintReadWrite, meta = (editcondition = "bEnablePhysicsInteraction"))
 		bool bAllowDownwardForce = true;
 
+	/**
+	* Physics contacts of the capsule with a smaller normal impulse are ignored by the landing velocity correction and the physics interaction.
+	* Sweep hits of the pawn's own movement carry no impulse and are never filtered. Floor contacts are still recorded for the ground state.
+	*/
+	UPROPERTY(Category = "Gravity Movement Component : Physics Interaction", EditAnywhere, BlueprintReadWrite, AdvancedDisplay, meta = (ClampMin = "0", UIMin = "0"))
+		float MinHitImpulse;
+
 	/** Information about the surface the Gravity pawn is standing on. */
 	UPROPERTY(Category = "Gravity Movement Component", VisibleInstanceOnly, BlueprintReadOnly)
 		FHitResult CurrentStandingSurface;
 
+	/** Hits of the last standing/falling sweep, filled if Ground Probe Multi Hit is enabled. The blocking hit, if any, is the last one. */
+	UPROPERTY(Category = "Gravity Movement Component", VisibleInstanceOnly, BlueprintReadOnly)
+		TArray<FHitResult> GroundProbeHits;
+
 	/** Information about the surface the Gravity pawn is standing on (Updated only when is moving on ground and VericalOrientation is based on surface Normal. */
 	UPROPERTY(Category = "Gravity Movement Component", VisibleInstanceOnly, BlueprintReadOnly)
 		FHitResult CurrentTracedSurface;
@@ -217,7 +334,7 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "Pawn|Components|GravityMovementComponent")
 		FVector GetGravityDirection() const;
 
-	/** Returns APlanetActor reference. */
+	/** Returns APlanetActor reference, or the automatically selected planet if the reference is null. */
 	UFUNCTION(BlueprintCallable, Category = "Pawn|Components|GravityMovementComponent")
 		APlanetActor* GetCurrentPlanet() const;
 
@@ -263,6 +380,25 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "Pawn|Components|GravityMovementComponent")
 		float GetInAirTime() const;
 
+	/** Returns the capsule velocity right after a jump started now. */
+	UFUNCTION(BlueprintCallable, Category = "Pawn|Components|GravityMovementComponent")
+		FVector GetJumpLaunchVelocity() const;
+
+	/** Predicts where a jump started now lands. Returns true if it lands within the prediction steps. */
+	UFUNCTION(BlueprintCallable, Category = "Pawn|Components|GravityMovementComponent")
+		bool PredictJump(FGravityJumpPrediction& OutPrediction) const;
+
+	/** Predicts where the capsule lands if launched from its location at LaunchVelocity. */
+	UFUNCTION(BlueprintCallable, Category = "Pawn|Components|GravityMovementComponent")
+		bool PredictTrajectory(const FVector& LaunchVelocity, FGravityJumpPrediction& OutPrediction) const;
+
+	/** Predicts one landing per launch velocity, the paths are integrated in parallel. */
+	UFUNCTION(BlueprintCallable, Category = "Pawn|Components|GravityMovementComponent")
+		void PredictTrajectories(const TArray<FVector>& LaunchVelocities, TArray<FGravityJumpPrediction>& OutPredictions) const;
+
+	/** Sets up Solver with the capsule shape and the gravity currently applied to the capsule. */
+	void SetupTrajectorySolver(FGravityTrajectorySolver& Solver) const;
+
 	FGravityInfo CurrentGravityInfo;
 
 	FOrientationInfo CurrentOrientationInfo;
@@ -275,14 +411,154 @@ protected:
 	/** Gravity movement component owner */
 	class AGravityPawn* PawnOwner;
 
+	/**
+	* Applies the responses to the capsule hits collected since the last call :
+	* one landing velocity correction, and one merged impulse per touched physics body.
+	*/
+	void FlushHitResponses();
+
+	/** Returns InterpSpeed, or 0 (no interpolation) below the EGS_High significance tier. */
+	float GetOrientationInterpSpeed(float InterpSpeed) const;
+
+	/** Impulse applied by DoJump, in the force mode of the current gravity. */
+	FVector GetJumpImpulse() const;
+
+	/** Returns the Planet Actor reference if set, otherwise the dominant planet at Location. */
+	APlanetActor* ResolvePlanet(const FVector& Location);
+
+	/** Gravity manager of the world, used for automatic planet selection. */
+	TWeakObjectPtr<class AGravityWorldManager> GravityManager;
+
+	/** Planet selected automatically when Point Gravity is used without a Planet Actor reference. */
+	TWeakObjectPtr<APlanetActor> AutoSelectedPlanet;
+
+	/** Planet of the current gravity if it is Point Gravity, used by bApplyGravityInSubsteps. */
+	TWeakObjectPtr<APlanetActor> PointGravityPlanet;
+
+	/** Point gravity evaluated in the physics substeps (bApplyGravityInSubsteps). */
+	FSubstepPointGravity SubstepGravity;
+	FCalculateCustomPhysics OnCalculateSubstepGravity;
+
+	/** Custom physics callback : applies SubstepGravity for one substep. */
+	void CalculateSubstepGravity(float DeltaTime, FBodyInstance* BodyInstance);
+
+	/** Returns true if this frame's ground and surface traces should be issued asynchronously. */
+	bool ShouldUseAsyncGroundQueries() const;
+
+	/**
+	* Reads the result of the async trace Handle issued last frame into OutHit and invalidates Handle.
+	* If OutHits is not null, it receives every hit of the trace.
+	* Returns false if no result is available, OutHit and OutHits are left unchanged.
+	*/
+	bool ConsumeAsyncGroundQuery(FTraceHandle& Handle, FHitResult& OutHit, TArray<FHitResult>* OutHits = nullptr) const;
+
+	/**
+	* Scene query parameters of the ground and surface traces, built once in InitializeComponent.
+	* Steady state ticks must not allocate : see the CustomGravity.Movement.SteadyStateTickDoesNotAllocate test.
+	*/
+	FCollisionQueryParams GroundQueryParams;
+
+#if ENABLE_DRAW_DEBUG
+	/** Draws a ground or surface trace the way Kismet traces do. */
+	void DrawGroundQuery(const FVector& Start, const FVector& End, const FCollisionShape& Shape, const FQuat& Rotation, const FHitResult& Hit, EDrawDebugTrace::Type DrawDebugType) const;
+#endif
+
+	/** Returns true if the last floor contact can be used as the ground this frame (bUseContactGroundCache). */
+	bool CanUseContactGroundCache() const;
+
+	/** Last floor contact of the capsule, reported by CapsuleHited. */
+	FHitResult FloorContactHit;
+
+	/** World time of FloorContactHit, negative if there is no usable floor contact. */
+	float FloorContactTime;
+
+	/** GFrameCounter of the last DoJump : floor contacts of the physics step applying the jump impulse are ignored. */
+	uint64 JumpFrame;
+
+	/** Pending async ground (standing/falling) trace. */
+	FTraceHandle GroundQueryHandle;
+
+	/** Pending async surface trace (EVO_SurfaceNormal). */
+	FTraceHandle SurfaceQueryHandle;
+
+	/** Applies the gravity force of CurrentGravityInfo, or queues it in the physics substeps (bApplyGravityInSubsteps). */
+	void ApplyCurrentGravity(const FVector& GravityForce);
+
+	/** Writes the result of the movement batch : capsule rotation, evaluated point gravity (if any) and gravity force. */
+	void ApplyMovementBatchResult(bool bRotationChanged, const FQuat& NewRotation, const FGravityInfo* EvaluatedGravityInfo, const FVector& GravityForce, bool bApplyGravity);
+
+	/** Sets the capsule rotation if bRotationChanged, and counts written and avoided rotation updates. */
+	void WriteCapsuleRotation(bool bRotationChanged, const FQuat& NewRotation);
+
+	/**
+	* One simulation step : ground detection, gravity selection, capsule orientation and gravity.
+	* Called once per tick, or once per fixed step if bUseFixedTimeStep is set.
+	*/
+	void SimulateMovement(float DeltaTime);
+
+	/** Advances the fixed step simulation by DeltaTime and writes the interpolated mesh rotation. */
+	void TickFixedTimeStep(float DeltaTime);
+
+	/** Rotates the pawn mesh by RotationOffset (capsule space) from its relative transform at the first fixed step. */
+	void WriteFixedStepMeshRotation(const FQuat& RotationOffset);
+
+	/** Puts the pawn mesh back to its relative transform at the first fixed step. */
+	void RestoreFixedStepMesh();
+
+	/** True if this frame's update goes through the movement batch of the gravity manager. */
+	bool ShouldUseMovementBatch() const { return bUseMovementBatch && !bUseFixedTimeStep; }
+
+	/** Cosine of OrientationAngleTolerance. */
+	float GetAlignedAngleCos() const;
+
 private:
 
+	friend class AGravityWorldManager;
+
+	/** True if orientation and gravity are computed by the movement batch of the gravity manager (CustomGravity.BatchedMovementUpdate). */
+	bool bUseMovementBatch;
+
+	/** Planet selected this frame for point gravity, evaluated by the movement batch. */
+	APlanetActor* BatchedGravityPlanet;
+
+	/** Significance tier of the owner. */
+	TEnumAsByte<EGravitySignificance::Type> Significance;
+
+	/** Impulse pushed to a physics body by the capsule hits of a frame. */
+	struct FPendingHitImpulse
+	{
+		TWeakObjectPtr<UPrimitiveComponent> Component;
+
+		/** Sums of the impulses and locations of the contacts, averaged when applied. */
+		FVector Impulse;
+		FVector Location;
+		int32 NumContacts;
+	};
+
+	/** Physics interaction impulses collected by CapsuleHited, applied by FlushHitResponses. Reused every frame. */
+	TArray<FPendingHitImpulse> PendingHitImpulses;
+
+	/** True if a hit asked for the landing velocity correction since the last FlushHitResponses. */
+	bool bPendingLandingVelocityCorrection;
+
 
 	float CurrentPlanetDistance;
 
 	bool bDebugIsEnabled;
 
-	FRotator CurrentCapsuleRotation;
+	/** Capsule rotation written by the last orientation update, start of the next interpolation step. */
+	FQuat CurrentCapsuleQuat;
+
+	/** Fixed step simulation state : unsimulated time, rotation of the previous step, gravity force of the last step. */
+	float FixedStepAccumulator;
+	FQuat PreviousFixedStepQuat;
+	FVector FixedStepGravityForce;
+	bool bHasFixedStepGravity;
+	bool bFixedTimeStepActive;
+
+	/** Relative transform of the pawn mesh when the fixed steps started, the interpolated rotation is applied on top of it. */
+	FVector FixedStepMeshRelativeLocation;
+	FQuat FixedStepMeshRelativeQuat;
 
 	float TimeInAir;
 
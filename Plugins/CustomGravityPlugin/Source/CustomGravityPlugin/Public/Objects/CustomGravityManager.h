@@ -142,6 +142,11 @@ public:
 
 };
 
+/** Called when the Global Custom Gravity changes. */
+DECLARE_MULTICAST_DELEGATE_OneParam(FOnGlobalCustomGravityChanged, const FGravityInfo& /*NewGravityInfo*/);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnGlobalCustomGravityChangedDynamic, const FGravityInfo&, NewGravityInfo);
+DECLARE_DYNAMIC_DELEGATE_OneParam(FGlobalCustomGravityChangedDelegate, const FGravityInfo&, NewGravityInfo);
+
 
 UCLASS()
 class CUSTOMGRAVITYPLUGIN_API UCustomGravityManager : public UBlueprintFunctionLibrary
@@ -154,44 +159,56 @@ public:
 	UCustomGravityManager();
 
 	/** Change Global Custom Gravity power.
-	* This change will affect all physics object using a CustomGravityComponent with GravityType set to "Global Custom Gravity".
+	* This change will affect all physics object of the world using a CustomGravityComponent with GravityType set to "Global Custom Gravity".
 	*/
-	UFUNCTION(BlueprintCallable, Category = "Global Custom Gravity", meta = (DisplayName = "Set Global Custom Gravity Power"))
-		static void SetGlobalCustomGravityPower(float NewGravityPower);
+	UFUNCTION(BlueprintCallable, Category = "Global Custom Gravity", meta = (WorldContext = "WorldContextObject", DisplayName = "Set Global Custom Gravity Power"))
+		static void SetGlobalCustomGravityPower(const UObject* WorldContextObject, float NewGravityPower);
 
 	/** Change Global Custom Gravity direction.
-	* This change will affect all physics object using a CustomGravityComponent with GravityType set to "Global Custom Gravity".
+	* This change will affect all physics object of the world using a CustomGravityComponent with GravityType set to "Global Custom Gravity".
 	*/
-	UFUNCTION(BlueprintCallable, Category = "Global Custom Gravity", meta = (DisplayName = "Set Global Custom Gravity Direction"))
-		static void SetGlobalCustomGravityDirection(const FVector& NewGravityDirection);
+	UFUNCTION(BlueprintCallable, Category = "Global Custom Gravity", meta = (WorldContext = "WorldContextObject", DisplayName = "Set Global Custom Gravity Direction"))
+		static void SetGlobalCustomGravityDirection(const UObject* WorldContextObject, const FVector& NewGravityDirection);
 
 	/** Change Global Custom Gravity force mode.
-	* 	* This change will affect all physics object using a CustomGravityComponent with GravityType set to "Global Custom Gravity".
+	* This change will affect all physics object of the world using a CustomGravityComponent with GravityType set to "Global Custom Gravity".
 	*/
-	UFUNCTION(BlueprintCallable, Category = "Global Custom Gravity", meta = (DisplayName = "Set Global Custom Gravity Force Mode"))
-		static void SetGlobalCustomGravityForceMode(EForceMode::Type NewForceMode);
+	UFUNCTION(BlueprintCallable, Category = "Global Custom Gravity", meta = (WorldContext = "WorldContextObject", DisplayName = "Set Global Custom Gravity Force Mode"))
+		static void SetGlobalCustomGravityForceMode(const UObject* WorldContextObject, EForceMode::Type NewForceMode);
 
 	/** Change Global Custom Gravity information.
-	* This change will affect all physics object using a CustomGravityComponent with GravityType set to "Global Custom Gravity".
+	* This change will affect all physics object of the world using a CustomGravityComponent with GravityType set to "Global Custom Gravity".
 	*/
-	UFUNCTION(BlueprintCallable, Category = "Global Custom Gravity", meta = (DisplayName = "Set Global Custom Gravity Info"))
-		static void SetGlobalCustomGravityInfo(const FGravityInfo& NewGravityInfo);
+	UFUNCTION(BlueprintCallable, Category = "Global Custom Gravity", meta = (WorldContext = "WorldContextObject", DisplayName = "Set Global Custom Gravity Info"))
+		static void SetGlobalCustomGravityInfo(const UObject* WorldContextObject, const FGravityInfo& NewGravityInfo);
 
 	/** returns Global Custom Gravity power */
-	UFUNCTION(BlueprintPure, Category = "Global Custom Gravity", meta = (DisplayName = "Global Custom Gravity Power"))
-		static float GetGlobalCustomGravityPower();
+	UFUNCTION(BlueprintPure, Category = "Global Custom Gravity", meta = (WorldContext = "WorldContextObject", DisplayName = "Global Custom Gravity Power"))
+		static float GetGlobalCustomGravityPower(const UObject* WorldContextObject);
 
 	/** returns Global Custom Gravity direction */
-	UFUNCTION(BlueprintPure, Category = "Global Custom Gravity", meta = (DisplayName = "Global Custom Gravity Direction"))
-		static FVector GetGlobalCustomGravityDirection();
+	UFUNCTION(BlueprintPure, Category = "Global Custom Gravity", meta = (WorldContext = "WorldContextObject", DisplayName = "Global Custom Gravity Direction"))
+		static FVector GetGlobalCustomGravityDirection(const UObject* WorldContextObject);
 
 	/** returns Global Custom Gravity force mode */
-	UFUNCTION(BlueprintPure, Category = "Global Custom Gravity", meta = (DisplayName = "Global Custom Gravity ForceMode"))
-		static TEnumAsByte<EForceMode::Type>  GetGlobalCustomGravityForceMode();
+	UFUNCTION(BlueprintPure, Category = "Global Custom Gravity", meta = (WorldContext = "WorldContextObject", DisplayName = "Global Custom Gravity ForceMode"))
+		static TEnumAsByte<EForceMode::Type>  GetGlobalCustomGravityForceMode(const UObject* WorldContextObject);
 
 	/** returns Global Custom Gravity information */
-	UFUNCTION(BlueprintPure, Category = "Global Custom Gravity", meta = (DisplayName = "Global Custom Gravity Info"))
-		static FGravityInfo  GetGlobalCustomGravityInfo();
+	UFUNCTION(BlueprintPure, Category = "Global Custom Gravity", meta = (WorldContext = "WorldContextObject", DisplayName = "Global Custom Gravity Info"))
+		static FGravityInfo  GetGlobalCustomGravityInfo(const UObject* WorldContextObject);
+
+	/** returns Global Custom Gravity version, incremented every time the Global Custom Gravity changes */
+	UFUNCTION(BlueprintPure, Category = "Global Custom Gravity", meta = (WorldContext = "WorldContextObject", DisplayName = "Global Custom Gravity Version"))
+		static int32 GetGlobalCustomGravityVersion(const UObject* WorldContextObject);
+
+	/** Calls Event every time the Global Custom Gravity of the world changes (once per frame at most). */
+	UFUNCTION(BlueprintCallable, Category = "Global Custom Gravity", meta = (WorldContext = "WorldContextObject", DisplayName = "Bind Event to Global Custom Gravity Changed"))
+		static void BindGlobalCustomGravityChanged(const UObject* WorldContextObject, const FGlobalCustomGravityChangedDelegate& Event);
+
+	/** Stops calling Event when the Global Custom Gravity of the world changes. */
+	UFUNCTION(BlueprintCallable, Category = "Global Custom Gravity", meta = (WorldContext = "WorldContextObject", DisplayName = "Unbind Event from Global Custom Gravity Changed"))
+		static void UnbindGlobalCustomGravityChanged(const UObject* WorldContextObject, const FGlobalCustomGravityChangedDelegate& Event);
 
 	/** Converts a GravityInfo struct value to a string */
 	UFUNCTION(BlueprintPure, meta = (DisplayName = "ToString (GravityInfo)", CompactNodeTitle = "->", BlueprintAutocast), Category = "Utilities|String")
@@ -205,9 +222,4 @@ public:
 	UFUNCTION(BlueprintPure, meta = (DisplayName = "ToString (ForceMode)", CompactNodeTitle = "->", BlueprintAutocast), Category = "Utilities|String")
 		static FString Conv_ForceModeToString(EForceMode::Type InForceMode);
 
-protected:
-
-	/** Global Custom Gravity Information. */
-	static FGravityInfo GlobalCustomGravityInfo;
-
 };
@@ -0,0 +1,115 @@
+// Copyright 2015 Elhoussine Mehnik (Mhousse1247). All Rights Reserved.
+//******************* http://ue4resources.com/ *********************//
+
+#pragma once
+
+#include "Engine/DataAsset.h"
+#include "GravityFieldAsset.generated.h"
+
+class IAsyncReadFileHandle;
+class IAsyncReadRequest;
+
+/**
+* Baked gravity directions around a planet mesh, in planet actor space.
+* The field is a sparse grid of bricks : only bricks close to the planet surface are stored.
+* Directions are quantized to 3 bytes and kept in non-inline bulk data, read asynchronously on first use instead of with the level.
+*/
+UCLASS(BlueprintType)
+class CUSTOMGRAVITYPLUGIN_API UGravityFieldAsset : public UDataAsset
+{
+	GENERATED_BODY()
+
+public:
+
+	/**
+	* Default UObject constructor.
+	*/
+	UGravityFieldAsset(const FObjectInitializer& ObjectInitializer);
+
+	// UObject interface
+	virtual void Serialize(FArchive& Ar) override;
+	virtual void BeginDestroy() override;
+	// End of UObject interface
+
+	/** Cells per brick side. */
+	static const int32 BrickCells = 8;
+
+	/** Samples per brick side, bricks store their border samples so a lookup never reads two bricks. */
+	static const int32 BrickSamples = BrickCells + 1;
+
+	/** Samples per brick. */
+	static const int32 SamplesPerBrick = BrickSamples * BrickSamples * BrickSamples;
+
+	/** Distance between two samples. */
+	UPROPERTY(EditAnywhere, Category = "Gravity Field : Bake Settings", meta = (ClampMin = "1", UIMin = "1"))
+		float CellSize;
+
+	/** Bricks farther than this distance from the planet surface are not stored, bodies there use point gravity. */
+	UPROPERTY(EditAnywhere, Category = "Gravity Field : Bake Settings", meta = (ClampMin = "0", UIMin = "0"))
+		float MaxSurfaceDistance;
+
+	/** Number of stored bricks. */
+	UPROPERTY(VisibleAnywhere, Category = "Gravity Field : Info")
+		int32 NumBricks;
+
+	/** Number of bricks along each axis of the field bounds. */
+	UPROPERTY(VisibleAnywhere, Category = "Gravity Field : Info")
+		FIntVector BrickGridSize;
+
+	/** Location of the first sample, in planet actor space. */
+	UPROPERTY(VisibleAnywhere, Category = "Gravity Field : Info")
+		FVector FieldOrigin;
+
+	/** Cell size the field was baked with. */
+	UPROPERTY(VisibleAnywhere, Category = "Gravity Field : Info")
+		float BakedCellSize;
+
+#if WITH_EDITOR
+	/**
+	* Samples the gravity directions around Collision (closest point on its simple collision) and replaces the field.
+	* LocalBounds is the collision bounds in FieldToWorld space. Returns false if Collision can not be queried.
+	*/
+	bool Bake(UPrimitiveComponent* Collision, const FTransform& FieldToWorld, const FBox& LocalBounds);
+#endif // WITH_EDITOR
+
+	/**
+	* Starts reading the bricks from the bulk data on the async IO threads. Lookups fail until the read completes.
+	* Bulk data that is already in memory or compressed on disk is copied immediately.
+	*/
+	void LoadField();
+
+	/** Returns true if lookups can be done. Safe on any thread. */
+	bool IsFieldLoaded() const { return bIsFieldLoaded; }
+
+	/**
+	* Trilinear lookup of the gravity direction at LocalLocation (planet actor space).
+	* Returns false outside the stored bricks.
+	*/
+	bool SampleGravityDirection(const FVector& LocalLocation, FVector& OutGravityDirection) const;
+
+private:
+
+	/** Brick slot of each cell of the brick grid, INDEX_NONE for bricks that are not stored. */
+	UPROPERTY()
+		TArray<int32> BrickIndices;
+
+	/** Quantized directions of all the stored bricks (3 int8 per sample), not inlined in the package. */
+	FByteBulkData BrickData;
+
+	/** Loaded copy of BrickData. Not modified once bIsFieldLoaded is set. */
+	TArray<int8> Samples;
+
+	/** Set once Samples holds the bricks. */
+	FThreadSafeBool bIsFieldLoaded;
+
+	/** Asynchronous read of BrickData started by LoadField(), released on the game thread once complete. */
+	IAsyncReadFileHandle* ReadFileHandle;
+	IAsyncReadRequest* ReadRequest;
+	FAsyncFileCallBack ReadCallback;
+
+	/** Waits for the pending read, if any, and releases it. */
+	void ReleaseReadRequest();
+
+	/** 1 / BakedCellSize. */
+	float InvCellSize;
+};
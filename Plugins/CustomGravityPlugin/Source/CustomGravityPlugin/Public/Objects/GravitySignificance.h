@@ -0,0 +1,93 @@
+// Copyright 2015 Elhoussine Mehnik (Mhousse1247). All Rights Reserved.
+//******************* http://ue4resources.com/ *********************//
+
+#pragma once
+
+#include "GravitySignificance.generated.h"
+
+class AGravityPawn;
+
+/** Update tiers of gravity pawns and gravity bodies, ranked by distance and view relevance to the local players. */
+UENUM(BlueprintType)
+namespace EGravitySignificance
+{
+	enum  Type
+	{
+		EGS_High 	UMETA(DisplayName = "High"),
+		EGS_Medium 	UMETA(DisplayName = "Medium"),
+		EGS_Low 	UMETA(DisplayName = "Low")
+	};
+}
+
+
+/**
+* Ranks the gravity pawns and gravity bodies of a world (CustomGravity.Significance).
+* Lower tiers tick less often, skip orientation interpolation and use cheaper ground probes (pawns),
+* or evaluate point gravity less often (gravity bodies).
+*/
+class CUSTOMGRAVITYPLUGIN_API FGravitySignificanceManager
+{
+public:
+
+	FGravitySignificanceManager();
+
+	/** Adds Pawn to the ranked pawns. */
+	void AddPawn(AGravityPawn* Pawn);
+
+	/** Removes Pawn from the ranked pawns. */
+	void RemovePawn(AGravityPawn* Pawn);
+
+	/**
+	* Gathers the local players view points and ranks the pawns, at most every CustomGravity.SignificanceUpdateInterval seconds.
+	* Returns true if the tiers were updated this call : gravity bodies should be ranked again with Evaluate().
+	*/
+	bool Update(UWorld* World, float DeltaTime);
+
+	/** Returns the tier of an object at Location, of bounds radius Radius. */
+	EGravitySignificance::Type Evaluate(const FVector& Location, float Radius, bool bRecentlyRendered) const;
+
+	/** Returns true if significance is enabled (CustomGravity.Significance). */
+	static bool IsEnabled();
+
+	/** Actor and mesh tick interval of a pawn in Tier, in seconds. */
+	static float GetTickInterval(EGravitySignificance::Type Tier);
+
+	/** Number of frames between two point gravity evaluations of a gravity body in Tier. */
+	static uint32 GetGravityUpdateFrames(EGravitySignificance::Type Tier);
+
+	/** Returns true if tiers should be drawn (CustomGravity.SignificanceDebug). */
+	static bool ShouldDrawDebug();
+
+#if ENABLE_DRAW_DEBUG
+	/** Draws the tier of an object at Location. */
+	static void DrawDebugTier(UWorld* World, const FVector& Location, float Radius, EGravitySignificance::Type Tier);
+#endif
+
+	/** Returns the number of ranked pawns. */
+	int32 GetNumPawns() const { return Pawns.Num(); }
+
+private:
+
+	struct FViewPoint
+	{
+		FVector Location;
+		FVector Direction;
+
+		/** Cosine of the half field of view, widened to keep objects at the screen edges relevant. */
+		float ViewConeCos;
+	};
+
+	void GatherViewPoints(UWorld* World);
+
+	/** Ranked pawns. */
+	TArray<TWeakObjectPtr<AGravityPawn>> Pawns;
+
+	/** Local players view points, gathered on each update. */
+	TArray<FViewPoint> ViewPoints;
+
+	/** Time left before the next ranking. */
+	float TimeToNextUpdate;
+
+	/** True if tiers other than EGS_High were handed out, so they can be reset once significance is disabled. */
+	bool bHasReducedTiers;
+};
@@ -0,0 +1,132 @@
+// Copyright 2015 Elhoussine Mehnik (Mhousse1247). All Rights Reserved.
+//******************* http://ue4resources.com/ *********************//
+
+#pragma once
+
+#include "GravityTrajectory.generated.h"
+
+class APlanetActor;
+
+/** Result of a predicted jump or fall. */
+USTRUCT(BlueprintType)
+struct CUSTOMGRAVITYPLUGIN_API FGravityJumpPrediction
+{
+	GENERATED_BODY()
+
+public:
+
+	/** True if the path hit something before the step budget ran out. */
+	UPROPERTY(BlueprintReadOnly, Category = "Jump Prediction")
+		bool bLands;
+
+	/** True if the hit surface is walkable for the gravity at the landing location. */
+	UPROPERTY(BlueprintReadOnly, Category = "Jump Prediction")
+		bool bLandsOnWalkableSurface;
+
+	/** Location of the swept shape when it hits, or at the end of the path if it does not land. */
+	UPROPERTY(BlueprintReadOnly, Category = "Jump Prediction")
+		FVector LandingLocation;
+
+	/** Impact point and normal of the landing hit. */
+	UPROPERTY(BlueprintReadOnly, Category = "Jump Prediction")
+		FVector ImpactPoint;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Jump Prediction")
+		FVector ImpactNormal;
+
+	/** Time (in seconds) from the launch to the landing, or to the end of the path. */
+	UPROPERTY(BlueprintReadOnly, Category = "Jump Prediction")
+		float LandingTime;
+
+	/** Velocity at the landing. */
+	UPROPERTY(BlueprintReadOnly, Category = "Jump Prediction")
+		FVector LandingVelocity;
+
+	/** Actor hit at the landing. */
+	UPROPERTY(BlueprintReadOnly, Category = "Jump Prediction")
+		AActor* LandingActor;
+
+	FGravityJumpPrediction()
+		: bLands(false)
+		, bLandsOnWalkableSurface(false)
+		, LandingLocation(FVector::ZeroVector)
+		, ImpactPoint(FVector::ZeroVector)
+		, ImpactNormal(FVector::ZeroVector)
+		, LandingTime(0.0f)
+		, LandingVelocity(FVector::ZeroVector)
+		, LandingActor(nullptr)
+	{
+	}
+};
+
+
+/**
+* Integrates ballistic paths under a point gravity (planet) or a constant gravity, and sweeps them against the world.
+* Path integration is pure math and can run on any thread. Sweeps are done on the game thread.
+*/
+struct CUSTOMGRAVITYPLUGIN_API FGravityTrajectorySolver
+{
+	/** Planet the point gravity is evaluated from, null for constant gravity. */
+	const APlanetActor* Planet;
+
+	/** Gravity acceleration when Planet is null. */
+	FVector ConstantAcceleration;
+
+	/** Multiplier of the planet gravity acceleration : gravity scale, divided by the mass for EFM_Force gravity. */
+	float PlanetAccelerationScale;
+
+	/** Integration time step and maximum number of steps of a path. */
+	float TimeStep;
+	int32 MaxSteps;
+
+	/**
+	* Number of integration steps covered by one sweep. Sweeps that hit are refined step by step.
+	* The sweep follows the chord of the steps with the shape inflated by how far the path sags away from it.
+	*/
+	int32 SweepStride;
+
+	/** Swept shape, trace channel and query parameters. The shape is aligned with the local gravity. */
+	FCollisionShape Shape;
+	ECollisionChannel TraceChannel;
+	FCollisionQueryParams QueryParams;
+
+	/** Minimum dot product between a hit normal and the local up vector for the landing to be walkable. */
+	float WalkableNormalDot;
+
+	FGravityTrajectorySolver();
+
+	/** Gravity acceleration at Location. */
+	FVector GetGravityAcceleration(const FVector& Location) const;
+
+	/**
+	* Integrates the path launched from Start at Velocity. OutLocations and OutVelocities receive MaxSteps + 1 points.
+	* Pure function, safe on any thread.
+	*/
+	void IntegratePath(const FVector& Start, const FVector& Velocity, FVector* OutLocations, FVector* OutVelocities) const;
+
+	/** Sweeps an integrated path and fills OutPrediction. Returns true if the path lands. Game thread only. */
+	bool SweepPath(UWorld* World, const FVector* Locations, const FVector* Velocities, FGravityJumpPrediction& OutPrediction) const;
+
+	/** Integrates and sweeps a single path. */
+	bool Predict(UWorld* World, const FVector& Start, const FVector& Velocity, FGravityJumpPrediction& OutPrediction) const;
+
+	/**
+	* Predicts one path per launch velocity, all launched from Start.
+	* Paths are integrated in parallel, then swept on the game thread.
+	*/
+	void PredictBatch(UWorld* World, const FVector& Start, const TArray<FVector>& Velocities, TArray<FGravityJumpPrediction>& OutPredictions) const;
+
+private:
+
+	/** Rotation of the swept shape at Location : aligned with the gravity. */
+	FQuat GetShapeRotation(const FVector& Location) const;
+
+	/** Sweeps the shape from Start to End, aligned with the gravity at Start. */
+	bool SweepSegment(UWorld* World, const FVector& Start, const FVector& End, FHitResult& OutHit) const;
+
+	/**
+	* Tests the chord of the steps from FirstStep to LastStep with a sphere bounding the shape in any orientation,
+	* inflated by the sag of the path between them. Returns false only if none of the steps can hit anything, whatever their rotation.
+	*/
+	bool TestChord(UWorld* World, const FVector* Locations, int32 FirstStep, int32 LastStep) const;
+};
@@ -0,0 +1,71 @@
+// Copyright 2015 Elhoussine Mehnik (Mhousse1247). All Rights Reserved.
+//******************* http://ue4resources.com/ *********************//
+
+#pragma once
+
+class APlanetActor;
+
+/**
+* Bounding volume hierarchy over the spheres of influence of the planets of a world.
+* Used to find the dominant planet of a location in logarithmic time.
+*/
+class CUSTOMGRAVITYPLUGIN_API FPlanetRegistry
+{
+public:
+
+	FPlanetRegistry();
+
+	/** Adds Planet to the registry. The hierarchy is rebuilt on the next Update(). */
+	void AddPlanet(APlanetActor* Planet);
+
+	/** Removes Planet from the registry. The hierarchy is rebuilt on the next Update(). */
+	void RemovePlanet(APlanetActor* Planet);
+
+	/** Rebuilds the hierarchy if planets were added, removed, moved or had their sphere of influence changed. */
+	void Update();
+
+	/**
+	* Returns the planet with the strongest influence at Location, null if Location is outside every sphere of influence.
+	* CurrentPlanet is kept unless another planet's influence is greater by more than Hysteresis (ratio),
+	* and stays valid up to (1 + Hysteresis) times its sphere of influence radius.
+	*/
+	APlanetActor* FindDominantPlanet(const FVector& Location, APlanetActor* CurrentPlanet, float Hysteresis) const;
+
+	/** Returns the number of registered planets. */
+	int32 Num() const { return Planets.Num(); }
+
+private:
+
+	struct FPlanetEntry
+	{
+		APlanetActor* Planet;
+		FVector Center;
+		float Radius;
+	};
+
+	struct FNode
+	{
+		/** Bounds of all the spheres of influence under this node. */
+		FBox Bounds;
+
+		/** Children indices, unused for leaves. */
+		int32 Children[2];
+
+		/** Planet entry index for leaves, INDEX_NONE otherwise. */
+		int32 PlanetIndex;
+	};
+
+	void Build();
+	int32 BuildNode(int32 Start, int32 Num);
+
+	/** Registered planets with their cached sphere of influence. */
+	TArray<FPlanetEntry> Planets;
+
+	/** Planet entry indices, ordered by the hierarchy build. */
+	TArray<int32> PlanetOrder;
+
+	/** Hierarchy nodes, the root is the first node. */
+	TArray<FNode> Nodes;
+
+	bool bNeedsRebuild;
+};
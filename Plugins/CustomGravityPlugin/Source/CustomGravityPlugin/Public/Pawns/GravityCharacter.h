@@ -57,6 +57,10 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Custom Pawn : Mesh Rotation Settings", meta = (ClampMin = "0", UIMin = "0"), meta = (editcondition = "!bInstantRotation"))
 		float RotationInterpSpeed;
 
+	/** The mesh rotation is only written when its yaw is more than this many degrees away from the desired yaw. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Custom Pawn : Mesh Rotation Settings", meta = (ClampMin = "0", UIMin = "0"), AdvancedDisplay)
+		float MeshRotationYawTolerance;
+
 protected:
 
 	/**Character Mesh Initial Value. */
@@ -20,10 +20,26 @@ public:
 	virtual void Tick(float DeltaSeconds) override;
 	virtual void NotifyHit(class UPrimitiveComponent* MyComp, class AActor* Other, class UPrimitiveComponent* OtherComp, bool bSelfMoved, FVector HitLocation, FVector HitNormal, FVector NormalImpulse, const FHitResult& Hit) override;
 	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+	virtual void PossessedBy(AController* NewController) override;
+	virtual void UnPossessed() override;
+	virtual void OnRep_Controller() override;
 	// End of AActor interface
 
 	virtual void UpdateMeshRotation(float DeltaTime);
 
+	/** Chooses when the mesh pose is evaluated : always for locally controlled pawns, only when rendered for the others (bOnlyTickPoseWhenRenderedIfRemote). */
+	virtual void UpdateMeshTickPoseMode();
+
+	/** Orients the debug gizmo along the current movement direction. Only written when debugging is enabled and the rotation changed. */
+	virtual void UpdateGizmoRotation();
+
+	/**
+	* Applies a significance tier (CustomGravity.Significance) : below EGS_High the actor and the mesh tick less often,
+	* and the movement component uses cheaper updates.
+	*/
+	virtual void SetSignificance(EGravitySignificance::Type NewSignificance);
+
 
 	/** Minimum view Pitch, in degrees. */
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Gravity Pawn : Camera Settings")
@@ -33,6 +49,25 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Gravity Pawn : Camera Settings")
 		float CameraPitchMax;
 
+	/**
+	* If true, the mesh animation is updated less often as the pawn gets smaller on screen (update rate optimizations),
+	* skipped frames are interpolated.
+	*/
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Gravity Pawn : Animation Settings")
+		bool bUseAnimationUpdateRateOptimizations;
+
+	/** If true, the pose of pawns not controlled locally is only evaluated when they are rendered. */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Gravity Pawn : Animation Settings")
+		bool bOnlyTickPoseWhenRenderedIfRemote;
+
+	/** With update rate optimizations, the animation of pawns not rendered is updated once every this many frames. */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Gravity Pawn : Animation Settings", meta = (ClampMin = "1", UIMin = "1", editcondition = "bUseAnimationUpdateRateOptimizations"))
+		int32 NonRenderedAnimUpdateRate;
+
+	/** With update rate optimizations, skipped frames are interpolated up to this update rate (in frames), and not beyond. */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Gravity Pawn : Animation Settings", meta = (ClampMin = "1", UIMin = "1", editcondition = "bUseAnimationUpdateRateOptimizations"))
+		int32 MaxAnimEvalRateForInterpolation;
+
 	/** Handle jump action. */
 	UFUNCTION(BlueprintCallable, Category = "Pawn|GravityPawn|Input", meta = (Keywords = "AddInput"))
 		virtual void Jump();
@@ -87,6 +122,10 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "Pawn|GravityPawn")
 		FVector GetCurrentRightDirection() const;
 
+	/**Returns the significance tier of this pawn, EGS_High unless CustomGravity.Significance is enabled. */
+	UFUNCTION(BlueprintCallable, Category = "Pawn|GravityPawn")
+		EGravitySignificance::Type GetSignificance() const;
+
 	/** Movement component used for movement. */
 	UPROPERTY(Category = "Gravity Pawn", VisibleDefaultsOnly, BlueprintReadOnly, meta = (AllowPrivateAccess = "true"))
 		UGravityMovementComponent* MovementComponent;
@@ -164,6 +203,22 @@ protected:
 	/** Current Right Movement Direction*/
 	FVector CurrentRightDirection;
 
+	/** Sets up the update rate optimizations of PawnMesh. */
+	void OnAnimUpdateRateParamsCreated(FAnimUpdateRateParameters* Params);
+
+	/** True between EnableDebugging() and DisableDebugging() : the gizmo is visible and kept up to date. */
+	bool bIsDebugging;
+
+	/** Current significance tier. */
+	TEnumAsByte<EGravitySignificance::Type> Significance;
+
+	/** Actor and mesh tick intervals at the EGS_High tier, as set up before the first significance change. */
+	float BaseActorTickInterval;
+	float BaseMeshTickInterval;
+
+	/** Frame of the last actor tick, to count the ticks saved by the significance tick intervals. */
+	uint64 LastTickFrame;
+
 
 
 };
\ No newline at end of file
@@ -4,3 +4,4 @@
 
 #include "Engine.h"
 
+DECLARE_STATS_GROUP(TEXT("Life"), STATGROUP_Life, STATCAT_Advanced);
@@ -12,12 +12,20 @@ ALifeCharacter::ALifeCharacter(const FObjectInitializer& ObjectInitializer)
 	: Super(ObjectInitializer)
 {
 	TimeOnOneFoot = 0.2f;
-	bCanStep = false;
 	bStartingJump = false;
+	bJumping = false;
 	SlowSteppingSpeed = 0.2f;
 	FastSteppingSpeed = 1.0f;
 	TimeBeforeJump = 0.5f;
 	JumpAnimationTime = 1.2f;
+
+	ForwardLastMovementInputValue = 0.0f;
+	RightLastMovementInputValue = 0.0f;
+	SteppingSpeed = SlowSteppingSpeed;
+	Gait = ELifeGait::LG_Idle;
+	GaitTime = 0.0f;
+	JumpState = ELifeJumpState::LJS_None;
+	JumpStateTime = 0.0f;
 }
 
 void ALifeCharacter::Tick(float DeltaTime)
@@ -26,6 +34,10 @@ void ALifeCharacter::Tick(float DeltaTime)
 
 	if (MovementComponent == NULL) { return; }
 
+	// Input axes were processed by the controller, which ticks first
+	UpdateGait(DeltaTime);
+	UpdateJumpState(DeltaTime);
+
 	if (MovementComponent->IsMovingOnGround())
 	{
 		AddMovementInput(CurrentForwardDirection.GetSafeNormal(), ForwardLastMovementInputValue * SteppingSpeed, false);
@@ -54,22 +66,6 @@ void ALifeCharacter::AddForwardMovement(float ScaleValue)
 	}
 
 	ForwardLastMovementInputValue = MovementComponent->IsMovingOnGround() ? ScaleValue : ScaleValue * MovementComponent->AirControlRatio;
-
-	if (ForwardLastMovementInputValue != 0.0f)
-	{
-		if (bCanStep)
-		{
-			bCanStep = false;
-			GetWorld()->GetTimerManager().SetTimer(SlowStepHandle, this, &ALifeCharacter::OnStep, TimeOnOneFoot, false);
-		}
-	}
-	else
-	{
-		bCanStep = true;
-		SteppingSpeed = SlowSteppingSpeed;
-		GetWorld()->GetTimerManager().ClearTimer(SlowStepHandle);
-		GetWorld()->GetTimerManager().ClearTimer(FastStepHandle);
-	}
 }
 
 void ALifeCharacter::AddRightMovement(float ScaleValue)
@@ -86,22 +82,6 @@ void ALifeCharacter::AddRightMovement(float ScaleValue)
 	}
 
 	RightLastMovementInputValue = MovementComponent->IsMovingOnGround() ? ScaleValue : ScaleValue * MovementComponent->AirControlRatio;
-
-	if (ForwardLastMovementInputValue != 0.0f)
-	{
-		if (bCanStep)
-		{
-			bCanStep = false;
-			GetWorld()->GetTimerManager().SetTimer(SlowStepHandle, this, &ALifeCharacter::OnStep, TimeOnOneFoot, false);
-		}
-	}
-	else
-	{
-		bCanStep = true;
-		SteppingSpeed = SlowSteppingSpeed;
-		GetWorld()->GetTimerManager().ClearTimer(SlowStepHandle);
-		GetWorld()->GetTimerManager().ClearTimer(FastStepHandle);
-	}
 }
 
 void ALifeCharacter::StopMovement()
@@ -110,18 +90,43 @@ void ALifeCharacter::StopMovement()
 	RightLastMovementInputValue = 0.0f;
 }
 
-void ALifeCharacter::OnStep()
+void ALifeCharacter::UpdateGait(float DeltaTime)
 {
-	SteppingSpeed = FastSteppingSpeed;
-	GetWorld()->GetTimerManager().ClearTimer(SlowStepHandle);
-	GetWorld()->GetTimerManager().SetTimer(FastStepHandle, this, &ALifeCharacter::OnStepFinish, TimeOnOneFoot, false);
+	if (ForwardLastMovementInputValue == 0.0f && RightLastMovementInputValue == 0.0f)
+	{
+		SetGait(ELifeGait::LG_Idle);
+	}
+	else if (Gait == ELifeGait::LG_Idle)
+	{
+		SetGait(ELifeGait::LG_SlowStep);
+	}
+	else
+	{
+		// Slow and fast steps alternate, each lasting TimeOnOneFoot
+		GaitTime += DeltaTime;
+		if (GaitTime >= TimeOnOneFoot)
+		{
+			const float Overflow = TimeOnOneFoot > 0.0f ? FMath::Fmod(GaitTime - TimeOnOneFoot, TimeOnOneFoot) : 0.0f;
+			SetGait(Gait == ELifeGait::LG_SlowStep ? ELifeGait::LG_FastStep : ELifeGait::LG_SlowStep);
+			GaitTime = Overflow;
+		}
+	}
+
+	SteppingSpeed = (Gait == ELifeGait::LG_FastStep) ? FastSteppingSpeed : SlowSteppingSpeed;
 }
 
-void ALifeCharacter::OnStepFinish()
+void ALifeCharacter::SetGait(ELifeGait::Type NewGait)
 {
-	bCanStep = true;
-	SteppingSpeed = SlowSteppingSpeed;
-	GetWorld()->GetTimerManager().ClearTimer(FastStepHandle);
+	if (Gait == NewGait)
+	{
+		return;
+	}
+
+	const ELifeGait::Type PreviousGait = Gait;
+	Gait = NewGait;
+	GaitTime = 0.0f;
+
+	OnGaitChanged.Broadcast(PreviousGait, NewGait);
 }
 
 void ALifeCharacter::Jump()
@@ -132,29 +137,45 @@ void ALifeCharacter::Jump()
 		{
 			UGameplayStatics::SpawnSoundAttached(JumpSound, GetRootComponent());
 		}
-		bStartingJump = true;
-		bJumping = true;
 		CurrentJumpDirection = GetMesh()->GetForwardVector();
-		GetWorld()->GetTimerManager().SetTimer(JumpReadyHandle, this, &ALifeCharacter::OnJumpReady, TimeBeforeJump, false);
+		SetJumpState(ELifeJumpState::LJS_Starting);
 	}
 }
 
-void ALifeCharacter::OnJumpReady()
+void ALifeCharacter::UpdateJumpState(float DeltaTime)
 {
-	bStartingJump = false;
+	if (JumpState == ELifeJumpState::LJS_None)
+	{
+		return;
+	}
 
-	GetWorld()->GetTimerManager().ClearTimer(JumpReadyHandle);
-	if (MovementComponent != NULL)
+	JumpStateTime += DeltaTime;
+
+	if (JumpState == ELifeJumpState::LJS_Starting && JumpStateTime >= TimeBeforeJump)
 	{
-		GetWorld()->GetTimerManager().SetTimer(JumpFinishHandle, this, &ALifeCharacter::OnJumpFinish, JumpAnimationTime, false);
+		const float Overflow = JumpStateTime - TimeBeforeJump;
+		SetJumpState(ELifeJumpState::LJS_Jumping);
+		JumpStateTime = Overflow;
+
 		MovementComponent->DoJump(CurrentJumpDirection);
 	}
+
+	if (JumpState == ELifeJumpState::LJS_Jumping && JumpStateTime >= JumpAnimationTime)
+	{
+		SetJumpState(ELifeJumpState::LJS_None);
+	}
 }
 
-void ALifeCharacter::OnJumpFinish()
+void ALifeCharacter::SetJumpState(ELifeJumpState::Type NewJumpState)
 {
-	bJumping = false;
-	GetWorld()->GetTimerManager().ClearTimer(JumpFinishHandle);
+	const ELifeJumpState::Type PreviousJumpState = JumpState;
+	JumpState = NewJumpState;
+	JumpStateTime = 0.0f;
+
+	bStartingJump = (NewJumpState == ELifeJumpState::LJS_Starting);
+	bJumping = (NewJumpState != ELifeJumpState::LJS_None);
+
+	OnJumpStateChanged.Broadcast(PreviousJumpState, NewJumpState);
 }
 
 void ALifeCharacter::TeleportCharacter(ALifeTeleporter* LifeTeleporter)
@@ -174,6 +195,63 @@ void ALifeCharacter::StopAllAnimMontages()
 	}
 }
 
+void ALifeCharacter::DeactivateForPool()
+{
+	StopAllAnimMontages();
+	StopMovement();
+	SetGait(ELifeGait::LG_Idle);
+	if (JumpState != ELifeJumpState::LJS_None)
+	{
+		SetJumpState(ELifeJumpState::LJS_None);
+	}
+
+	SetActorHiddenInGame(true);
+	SetActorEnableCollision(false);
+	SetActorTickEnabled(false);
+
+	if (MovementComponent)
+	{
+		MovementComponent->StopMovementImmediately();
+		MovementComponent->Deactivate();
+	}
+	if (CapsuleComponent)
+	{
+		CapsuleComponent->SetSimulatePhysics(false);
+	}
+	if (PawnMesh)
+	{
+		PawnMesh->Deactivate();
+	}
+}
+
+void ALifeCharacter::ReactivateFromPool(const FTransform& Transform)
+{
+	SetActorTransform(Transform, false, nullptr, ETeleportType::TeleportPhysics);
+
+	if (CapsuleComponent)
+	{
+		CapsuleComponent->SetSimulatePhysics(true);
+	}
+	if (MovementComponent)
+	{
+		MovementComponent->Activate(true);
+		MovementComponent->ResetMovementState();
+		MovementComponent->StopMovementImmediately();
+	}
+	if (PawnMesh)
+	{
+		PawnMesh->Activate(true);
+		PawnMesh->SetRelativeRotation(MeshStartRotation);
+	}
+
+	CurrentForwardDirection = GetActorForwardVector();
+	CurrentRightDirection = GetActorRightVector();
+
+	SetActorHiddenInGame(false);
+	SetActorEnableCollision(true);
+	SetActorTickEnabled(true);
+}
+
 void ALifeCharacter::FinishLevel()
 {
 	ALifePlayerController* LifePlayerController = Cast<ALifePlayerController>(Controller);
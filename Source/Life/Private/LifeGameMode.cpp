@@ -6,7 +6,12 @@
 #include "LifeGameMode.h"
 
 
-
+static TAutoConsoleVariable<int32> CVarPooledCharacters(
+	TEXT("Life.PooledCharacters"),
+	1,
+	TEXT("1 : teleports hide and reuse the character (default).\n")
+	TEXT("0 : teleports destroy the character and spawn a new one."),
+	ECVF_Default);
 
 
 ALifeGameMode::ALifeGameMode(const FObjectInitializer& ObjectInitializer) : Super(ObjectInitializer)
@@ -17,9 +22,35 @@ ALifeGameMode::ALifeGameMode(const FObjectInitializer& ObjectInitializer) : Supe
 
 class ALifeCharacter* ALifeGameMode::GetNewLifeCharacter(FTransform SpawnTransform, FActorSpawnParameters SpawnInfo)
 {
+	while (LifeCharacterPool.Num() > 0)
+	{
+		ALifeCharacter* LifeCharacter = LifeCharacterPool.Pop(false);
+		if (LifeCharacter && !LifeCharacter->IsPendingKill())
+		{
+			LifeCharacter->ReactivateFromPool(SpawnTransform);
+			return LifeCharacter;
+		}
+	}
 	return GetWorld()->SpawnActor<ALifeCharacter>(DefaultPawnClass, SpawnTransform, SpawnInfo);
 }
 
+void ALifeGameMode::ReleaseLifeCharacter(class ALifeCharacter* LifeCharacter)
+{
+	if (LifeCharacter == NULL)
+	{
+		return;
+	}
+
+	if (CVarPooledCharacters.GetValueOnGameThread() == 0)
+	{
+		LifeCharacter->Destroy();
+		return;
+	}
+
+	LifeCharacter->DeactivateForPool();
+	LifeCharacterPool.AddUnique(LifeCharacter);
+}
+
 UClass* ALifeGameMode::GetDefaultPawnClassForController_Implementation(AController* InController)
 {
 	return NULL;
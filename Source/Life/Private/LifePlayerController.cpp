@@ -7,6 +7,10 @@
 #include "LifePickup_Coin.h"
 #include "LifePlayerController.h"
 
+/** Teleport hitches : stat Life */
+DECLARE_CYCLE_STAT(TEXT("Teleport Release Character"), STAT_TeleportReleaseCharacter, STATGROUP_Life);
+DECLARE_CYCLE_STAT(TEXT("Teleport Place Character"), STAT_TeleportPlaceCharacter, STATGROUP_Life);
+
 
 
 ALifePlayerController::ALifePlayerController(const FObjectInitializer& ObjectInitializer) : Super(ObjectInitializer)
@@ -140,8 +144,20 @@ void ALifePlayerController::StartTeleporting()
 {
 	GetWorld()->GetTimerManager().ClearTimer(StartTeleportHandle);
 	GetWorld()->GetTimerManager().SetTimer(TeleportHandle, this, &ALifePlayerController::FinishTeleporting, TeleporterDestination->TeleportTime, false);
+
+	SCOPE_CYCLE_COUNTER(STAT_TeleportReleaseCharacter);
+
+	ALifeCharacter* TeleportedCharacter = LifeCharacter;
 	UnPossess();
-	LifeCharacter->Destroy();
+	ALifeGameMode* LifeGameMode = Cast<ALifeGameMode>(GetWorld()->GetAuthGameMode());
+	if (LifeGameMode)
+	{
+		LifeGameMode->ReleaseLifeCharacter(TeleportedCharacter);
+	}
+	else if (TeleportedCharacter)
+	{
+		TeleportedCharacter->Destroy();
+	}
 	LifeCharacter = NULL;
 }
 
@@ -170,7 +186,12 @@ void ALifePlayerController::FinishTeleporting()
 					FActorSpawnParameters SpawnInfo;
 					SpawnInfo.Instigator = Instigator;
 					SpawnInfo.ObjectFlags |= RF_Transient;	// We never want to save default player pawns into a map
-					Possess(LifeGameMode->GetNewLifeCharacter(TeleporterDestinationTransform, SpawnInfo));
+
+					{
+						SCOPE_CYCLE_COUNTER(STAT_TeleportPlaceCharacter);
+						Possess(LifeGameMode->GetNewLifeCharacter(TeleporterDestinationTransform, SpawnInfo));
+					}
+
 					GetWorld()->GetTimerManager().SetTimer(TeleportHandle, this, &ALifePlayerController::SwitchToCharacterCamera, TeleporterDestination->CameraWaitTime, false);
 				}
 			}
@@ -3,8 +3,32 @@
 #include "Life.h"
 #include "LifeCharacter.h"
 #include "LifeTeleporter.h"
+#include "AudioDevice.h"
+#include "ContentStreaming.h"
+#include "Sound/SoundCue.h"
+#include "Sound/SoundNodeWavePlayer.h"
 
 
+/** Decompresses the waves of SoundCue ahead of their first play. */
+static void PrecacheSoundCue(UWorld* World, USoundCue* SoundCue)
+{
+	FAudioDevice* AudioDevice = World ? World->GetAudioDevice() : nullptr;
+	if (AudioDevice == nullptr || SoundCue == nullptr)
+	{
+		return;
+	}
+
+	TArray<USoundNodeWavePlayer*> WavePlayers;
+	SoundCue->RecursiveFindNode<USoundNodeWavePlayer>(SoundCue->FirstNode, WavePlayers);
+	for (USoundNodeWavePlayer* WavePlayer : WavePlayers)
+	{
+		if (USoundWave* SoundWave = WavePlayer->GetSoundWave())
+		{
+			AudioDevice->Precache(SoundWave);
+		}
+	}
+}
+
 
 ALifeTeleporter::ALifeTeleporter(const FObjectInitializer& ObjectInitializer) : Super(ObjectInitializer)
 {
@@ -36,9 +60,16 @@ ALifeTeleporter::ALifeTeleporter(const FObjectInitializer& ObjectInitializer) :
 	ActivePSC->SetupAttachment(RootComponent);
 
 	bCanTeleport = true;
+	bDestinationPrewarmed = false;
+	bArrivalPrewarmed = false;
 	TeleportTime = 2.0f;
 	CameraWaitTime = 1.0f;
 	TeleportInactiveTime = 4.0f;
+	PrewarmDistance = 3000.0f;
+
+	// Only checks the distance to the player
+	PrimaryActorTick.bCanEverTick = true;
+	PrimaryActorTick.TickInterval = 0.25f;
 }
 
 void ALifeTeleporter::BeginPlay()
@@ -48,6 +79,82 @@ void ALifeTeleporter::BeginPlay()
 	{
 		UGameplayStatics::SpawnSoundAttached(TeleporterActiveSound, GetRootComponent());
 	}
+	if (OtherTeleporter == NULL || PrewarmDistance <= 0.0f)
+	{
+		SetActorTickEnabled(false);
+	}
+}
+
+void ALifeTeleporter::Tick(float DeltaSeconds)
+{
+	Super::Tick(DeltaSeconds);
+
+	APawn* PlayerPawn = UGameplayStatics::GetPlayerPawn(this, 0);
+	if (PlayerPawn == NULL || OtherTeleporter == NULL)
+	{
+		return;
+	}
+
+	if (FVector::DistSquared(PlayerPawn->GetActorLocation(), GetActorLocation()) <= FMath::Square(PrewarmDistance))
+	{
+		PrewarmDestination();
+
+		// Kept alive while the player is close, the destination camera is shown as soon as the player enters
+		OtherTeleporter->PrestreamArrival(PrimaryActorTick.TickInterval * 2.0f);
+	}
+}
+
+void ALifeTeleporter::PrewarmDestination()
+{
+	if (bDestinationPrewarmed)
+	{
+		return;
+	}
+	bDestinationPrewarmed = true;
+
+	for (int32 Index = 0; Index < DestinationLevels.Num(); ++Index)
+	{
+		FLatentActionInfo LatentInfo;
+		LatentInfo.CallbackTarget = this;
+		LatentInfo.UUID = Index;
+		LatentInfo.Linkage = 0;
+		UGameplayStatics::LoadStreamLevel(this, DestinationLevels[Index], true, false, LatentInfo);
+	}
+
+	PrecacheSoundCue(GetWorld(), TeleportSound);
+	if (OtherTeleporter)
+	{
+		OtherTeleporter->PrewarmArrival();
+	}
+}
+
+void ALifeTeleporter::PrewarmArrival()
+{
+	if (bArrivalPrewarmed)
+	{
+		return;
+	}
+	bArrivalPrewarmed = true;
+
+	if (TeleportPSC && TeleportPSC->Template)
+	{
+		TeleportPSC->InitParticles();
+	}
+	PrecacheSoundCue(GetWorld(), TeleportReceiveSound);
+}
+
+void ALifeTeleporter::PrestreamArrival(float Duration)
+{
+	PrestreamTextures(Duration, true);
+
+	if (TeleporterCamera)
+	{
+		IStreamingManager::Get().AddViewSlaveLocation(TeleporterCamera->GetActorLocation(), 1.0f, false, Duration);
+	}
+	else if (TeleportDestinationComponent)
+	{
+		IStreamingManager::Get().AddViewSlaveLocation(TeleportDestinationComponent->GetComponentLocation(), 1.0f, false, Duration);
+	}
 }
 
 void ALifeTeleporter::NotifyActorBeginOverlap(class AActor* Other)
@@ -64,6 +171,9 @@ void ALifeTeleporter::DoTeleport(ALifeCharacter* LifeCharacter)
 {
 	if (OtherTeleporter)
 	{
+		// The player may have started within PrewarmDistance : start the loads before the arrival at least
+		PrewarmDestination();
+
 		if (TeleportPSC)
 		{
 			TeleportPSC->ActivateSystem();
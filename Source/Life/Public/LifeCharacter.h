@@ -6,6 +6,32 @@
 #include "GravityCharacter.h"
 #include "LifeCharacter.generated.h"
 
+/** Stepping phases while moving on the ground. */
+UENUM(BlueprintType)
+namespace ELifeGait
+{
+	enum Type
+	{
+		LG_Idle 	UMETA(DisplayName = "Idle"),
+		LG_SlowStep 	UMETA(DisplayName = "Slow Step"),
+		LG_FastStep 	UMETA(DisplayName = "Fast Step")
+	};
+}
+
+/** Jump phases : wind-up before the impulse, then the jump animation. */
+UENUM(BlueprintType)
+namespace ELifeJumpState
+{
+	enum Type
+	{
+		LJS_None 	UMETA(DisplayName = "None"),
+		LJS_Starting 	UMETA(DisplayName = "Starting"),
+		LJS_Jumping 	UMETA(DisplayName = "Jumping")
+	};
+}
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FOnLifeGaitChanged, TEnumAsByte<ELifeGait::Type>, PreviousGait, TEnumAsByte<ELifeGait::Type>, NewGait);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FOnLifeJumpStateChanged, TEnumAsByte<ELifeJumpState::Type>, PreviousState, TEnumAsByte<ELifeJumpState::Type>, NewState);
 
 /**
  * Gravity character
@@ -25,6 +51,12 @@ public:
 
 	void TeleportCharacter(class ALifeTeleporter* LifeTeleporter);
 	void StopAllAnimMontages();
+
+	/** Hides the character and stops its ticking, physics and collision while it waits in the game mode pool. */
+	void DeactivateForPool();
+
+	/** Moves a pooled character to Transform and restarts it with reset movement, gravity and animation state. */
+	void ReactivateFromPool(const FTransform& Transform);
 	UFUNCTION(BlueprintCallable)
 		void FinishLevel();
 
@@ -32,19 +64,36 @@ public:
 	UPROPERTY(EditDefaultsOnly, Category = Effects)
 		USoundCue* JumpSound;
 
+	/** Called when the stepping phase changes. */
+	UPROPERTY(BlueprintAssignable, Category = "Animation")
+		FOnLifeGaitChanged OnGaitChanged;
+
+	/** Called when the jump phase changes. */
+	UPROPERTY(BlueprintAssignable, Category = "Animation")
+		FOnLifeJumpStateChanged OnJumpStateChanged;
+
+	UFUNCTION(BlueprintCallable, Category = "Animation")
+		ELifeGait::Type GetGait() const { return Gait; }
+
+	UFUNCTION(BlueprintCallable, Category = "Animation")
+		ELifeJumpState::Type GetJumpState() const { return JumpState; }
+
+	/** True while waiting for the jump impulse (LJS_Starting). */
 	bool bStartingJump;
 
 protected:
-	FTimerHandle SlowStepHandle;
-	FTimerHandle FastStepHandle;
-	FTimerHandle JumpReadyHandle;
-	FTimerHandle JumpFinishHandle;
-
 	float ForwardLastMovementInputValue;
 	float RightLastMovementInputValue;
-	bool bCanStep;
 	float SteppingSpeed;
 
+	/** Current stepping phase and time spent in it, advanced by Tick. */
+	TEnumAsByte<ELifeGait::Type> Gait;
+	float GaitTime;
+
+	/** Current jump phase and time spent in it, advanced by Tick. */
+	TEnumAsByte<ELifeJumpState::Type> JumpState;
+	float JumpStateTime;
+
 	FVector CurrentJumpDirection;
 
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, meta = (AllowPrivateAccess = "true"))
@@ -65,14 +114,14 @@ protected:
 	UPROPERTY(EditAnywhere, Category = "Animation")
 		float JumpAnimationTime;
 
-	UFUNCTION()
-		void OnStep();
-	UFUNCTION()
-		void OnStepFinish();
-	UFUNCTION()
-		void OnJumpReady();
-	UFUNCTION()
-		void OnJumpFinish();
+	/** Advances the stepping phases from this frame's movement input and updates SteppingSpeed. */
+	void UpdateGait(float DeltaTime);
+
+	/** Advances the jump phases, the jump impulse is applied at the end of LJS_Starting. */
+	void UpdateJumpState(float DeltaTime);
+
+	void SetGait(ELifeGait::Type NewGait);
+	void SetJumpState(ELifeJumpState::Type NewJumpState);
 
 
 };
@@ -14,9 +14,17 @@ class LIFE_API ALifeGameMode : public AGameMode
 {
 	GENERATED_UCLASS_BODY()
 public:
+	/** Returns a pooled character moved to SpawnTransform, or spawns a new one if the pool is empty. */
 	class ALifeCharacter* GetNewLifeCharacter(FTransform SpawnTransform, FActorSpawnParameters SpawnInfo);
 
+	/** Deactivates an unpossessed character and keeps it for the next GetNewLifeCharacter (Life.PooledCharacters), or destroys it. */
+	void ReleaseLifeCharacter(class ALifeCharacter* LifeCharacter);
+
 protected:
+	/** Released characters, waiting to be reused. */
+	UPROPERTY(Transient)
+		TArray<class ALifeCharacter*> LifeCharacterPool;
+
 	virtual UClass* GetDefaultPawnClassForController_Implementation(AController* InController) override;
 	virtual void InitGame(const FString& MapName, const FString& Options, FString& ErrorMessage) override;
 	virtual void BeginPlay() override;
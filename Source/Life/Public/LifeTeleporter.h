@@ -18,6 +18,7 @@ public:
 	/** teleporter on touch */
 	virtual void NotifyActorBeginOverlap(class AActor* Other) override;
 	virtual void BeginPlay() override;
+	virtual void Tick(float DeltaSeconds) override;
 
 	/** Teleport destination */
 	UPROPERTY(EditDefaultsOnly, Category = Teleporter)
@@ -39,6 +40,20 @@ public:
 	UPROPERTY(EditDefaultsOnly, Category = Effects)
 		UParticleSystemComponent* TeleportPSC;
 
+	/** Streaming levels of the destination region, loaded when the player comes within PrewarmDistance of this teleporter. */
+	UPROPERTY(EditAnywhere, Category = Teleporter)
+		TArray<FName> DestinationLevels;
+
+	/** Distance to this teleporter at which the destination region is streamed in and the destination teleporter is pre-warmed. 0 disables it. */
+	UPROPERTY(EditAnywhere, Category = Teleporter)
+		float PrewarmDistance;
+
+	/** Creates the particles of TeleportPSC and decompresses the teleport sounds, once. */
+	void PrewarmArrival();
+
+	/** Streams the textures around this teleporter and its camera in for the next Duration seconds. */
+	void PrestreamArrival(float Duration);
+
 protected:
 
 
@@ -78,8 +93,13 @@ protected:
 	UFUNCTION()
 		void PlayTeleportReceive();
 
+	/** Requests the destination levels and pre-warms the other teleporter, once. */
+	void PrewarmDestination();
+
 private:
 	bool bCanTeleport;
+	bool bDestinationPrewarmed;
+	bool bArrivalPrewarmed;
 	FTimerHandle CanTeleportHandle;
 	FTimerHandle TeleportReceiveHandle;
 